@@ -0,0 +1,163 @@
+#include "BoardView.h"
+
+#include <QApplication>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+
+#include <algorithm>
+
+// The grid image is five squares wide; holes sit in the middle of their
+// square, at these (column, row) squares.
+static const int squareSize = 100;
+static const int pieceSize = 50;
+static const QPoint squares[PicariaBoard::HoleCount] = {
+    QPoint(0, 0), QPoint(2, 0), QPoint(4, 0),
+    QPoint(1, 1), QPoint(3, 1),
+    QPoint(0, 2), QPoint(2, 2), QPoint(4, 2),
+    QPoint(1, 3), QPoint(3, 3),
+    QPoint(0, 4), QPoint(2, 4), QPoint(4, 4)
+};
+
+static QPixmap scaled(const char* name, int size) {
+    // Scaled once to the device pixels, so painting never scales.
+    qreal ratio = qApp->devicePixelRatio();
+    QPixmap pixmap = QPixmap(name).scaled(QSize(size, size) * ratio, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    pixmap.setDevicePixelRatio(ratio);
+    return pixmap;
+}
+
+BoardView::BoardView(QWidget *parent)
+        : QWidget(parent),
+          m_mode(PicariaBoard::NineHoles),
+          m_pressed(-1) {
+    for (int id = 0; id < PicariaBoard::HoleCount; ++id)
+        m_states[id] = BoardView::EmptyState;
+
+    // The grid covers the whole widget.
+    this->setAttribute(Qt::WA_OpaquePaintEvent);
+    this->setFixedSize(this->sizeHint());
+}
+
+BoardView::~BoardView() {
+}
+
+void BoardView::setMode(PicariaBoard::Mode mode) {
+    this->apply(mode, m_states);
+}
+
+void BoardView::setState(int id, State state) {
+    Q_ASSERT(id >= 0 && id < PicariaBoard::HoleCount);
+    State states[PicariaBoard::HoleCount];
+    std::copy(m_states, m_states + PicariaBoard::HoleCount, states);
+    states[id] = state;
+    this->apply(m_mode, states);
+}
+
+void BoardView::setBoard(const PicariaBoard& board, uint16_t selectable) {
+    State states[PicariaBoard::HoleCount];
+    for (int id = 0; id < PicariaBoard::HoleCount; ++id) {
+        switch (board.cellAt(id)) {
+            case PicariaBoard::RedCell:
+                states[id] = BoardView::RedState;
+                break;
+            case PicariaBoard::BlueCell:
+                states[id] = BoardView::BlueState;
+                break;
+            default:
+                states[id] = selectable & (1u << id) ? BoardView::SelectableState : BoardView::EmptyState;
+                break;
+        }
+    }
+    this->apply(board.mode(), states);
+}
+
+void BoardView::reset() {
+    State states[PicariaBoard::HoleCount];
+    std::fill(states, states + PicariaBoard::HoleCount, BoardView::EmptyState);
+    m_pressed = -1;
+    this->apply(m_mode, states);
+}
+
+void BoardView::apply(PicariaBoard::Mode mode, const State* states) {
+    // Collect the whole diff first, so that it costs one repaint and one
+    // signal however many holes changed.
+    int changed = 0;
+    if (mode != m_mode) {
+        m_mode = mode;
+        changed = (1 << PicariaBoard::HoleCount) - 1;
+    }
+    for (int id = 0; id < PicariaBoard::HoleCount; ++id) {
+        if (m_states[id] != states[id]) {
+            m_states[id] = states[id];
+            changed |= 1 << id;
+        }
+    }
+    if (changed == 0)
+        return;
+
+    QRegion dirty;
+    for (int id = 0; id < PicariaBoard::HoleCount; ++id)
+        if (changed & (1 << id))
+            dirty += this->holeRect(id);
+    this->update(dirty);
+    emit statesChanged(changed);
+}
+
+QRect BoardView::holeRect(int id) const {
+    return QRect(squares[id] * squareSize, QSize(squareSize, squareSize));
+}
+
+int BoardView::holeAt(const QPoint& point) const {
+    for (int id = 0; id < PicariaBoard::HoleCount; ++id)
+        if (this->isHole(id) && this->holeRect(id).contains(point))
+            return id;
+    return -1;
+}
+
+QSize BoardView::sizeHint() const {
+    return QSize(5 * squareSize, 5 * squareSize);
+}
+
+void BoardView::paintEvent(QPaintEvent* event) {
+    QPainter painter(this);
+    QRect dirty = event->rect();
+
+    painter.drawPixmap(dirty, BoardView::background(), dirty);
+    for (int id = 0; id < PicariaBoard::HoleCount; ++id) {
+        QRect square = this->holeRect(id);
+        if (!this->isHole(id) || !dirty.intersects(square))
+            continue;
+
+        QRect piece(QPoint(0, 0), QSize(pieceSize, pieceSize));
+        piece.moveCenter(square.center());
+        painter.drawPixmap(piece, BoardView::stateToPixmap(m_states[id]));
+    }
+}
+
+void BoardView::mousePressEvent(QMouseEvent* event) {
+    // Like a button, a click is a press and a release on the same hole.
+    m_pressed = event->button() == Qt::LeftButton ? this->holeAt(event->pos()) : -1;
+}
+
+void BoardView::mouseReleaseEvent(QMouseEvent* event) {
+    int id = m_pressed;
+    m_pressed = -1;
+    if (event->button() == Qt::LeftButton && id >= 0 && this->holeAt(event->pos()) == id)
+        emit clicked(id);
+}
+
+const QPixmap& BoardView::stateToPixmap(State state) {
+    static const QPixmap pixmaps[] = {
+        scaled(":empty", pieceSize),
+        scaled(":red", pieceSize),
+        scaled(":blue", pieceSize),
+        scaled(":selectable", pieceSize)
+    };
+    return pixmaps[state];
+}
+
+const QPixmap& BoardView::background() {
+    static const QPixmap grid(":grid");
+    return grid;
+}
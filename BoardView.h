@@ -0,0 +1,73 @@
+#ifndef BOARDVIEW_H
+#define BOARDVIEW_H
+
+#include <QPixmap>
+#include <QWidget>
+
+#include "PicariaBoard.h"
+
+// The whole board as one widget: the grid and every hole are painted in a
+// single paintEvent, and clicks are mapped to holes here. A state change
+// only repaints the square of its hole; setBoard() applies a whole diff
+// with one repaint and one statesChanged() signal.
+class BoardView : public QWidget {
+    Q_OBJECT
+
+public:
+    enum State {
+        EmptyState,
+        RedState,
+        BlueState,
+        SelectableState
+    };
+    Q_ENUM(State)
+
+    explicit BoardView(QWidget *parent = nullptr);
+    virtual ~BoardView();
+
+    PicariaBoard::Mode mode() const { return m_mode; }
+    void setMode(PicariaBoard::Mode mode);
+
+    State state(int id) const { return m_states[id]; }
+    void setState(int id, State state);
+
+    // Shows the board, with the holes in selectable marked. Only the holes
+    // that differ from what is shown change.
+    void setBoard(const PicariaBoard& board, uint16_t selectable = 0);
+
+    bool isHole(int id) const { return id >= 0 && id < PicariaBoard::HoleCount && (PicariaBoard::holes(m_mode) & (1u << id)); }
+
+    // Square of the board a hole answers clicks in, and the hole under a
+    // point, or -1.
+    QRect holeRect(int id) const;
+    int holeAt(const QPoint& point) const;
+
+    QSize sizeHint() const override;
+
+public slots:
+    void reset();
+
+signals:
+    void clicked(int id);
+    // Bit n of holes is set when hole n changed.
+    void statesChanged(int holes);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+
+private:
+    PicariaBoard::Mode m_mode;
+    State m_states[PicariaBoard::HoleCount];
+    int m_pressed;
+
+    void apply(PicariaBoard::Mode mode, const State* states);
+
+    // Piece images decoded and scaled once, shared by every view.
+    static const QPixmap& stateToPixmap(State state);
+    static const QPixmap& background();
+
+};
+
+#endif // BOARDVIEW_H
@@ -1,83 +1,103 @@
 #include "Picaria.h"
+#include "BoardView.h"
+#include "PicariaBook.h"
+#include "PicariaDataFile.h"
+#include "PicariaMcts.h"
+#include "PicariaOracle.h"
+#include "PicariaRecord.h"
+#include "PicariaSearch.h"
+#include "PicariaTablebase.h"
+#include "PicariaWorker.h"
 #include "ui_Picaria.h"
 
+#include <QCoreApplication>
 #include <QDebug>
+#include <QDir>
+#include <QFileDialog>
 #include <QMessageBox>
+#include <QStandardPaths>
 #include <QActionGroup>
-#include <QSignalMapper>
-
-Picaria::Player state2player(Hole::State state) {
-    switch (state) {
-        case Hole::RedState:
-            return Picaria::RedPlayer;
-        case Hole::BlueState:
-            return Picaria::BluePlayer;
-        default:
-            Q_UNREACHABLE();
-    }
-}
 
-Hole::State player2state(Picaria::Player player) {
-    return player == Picaria::RedPlayer ? Hole::RedState : Hole::BlueState;
-}
+// Thinking times, in milliseconds: the computer's move, a hint asked for
+// by the user, and pondering on the user's position during the user's turn.
+// Each is a hard budget: the search answers within it, and starts no new
+// iteration after half of it.
+static const int computerTime = 500;
+static const int hintTime = 1000;
+static const int ponderTime = 30000;
+
+// Solved positions and book moves, written by picaria-solve and
+// picaria-book. Looked up next to the executable, then in the working
+// directory.
+static const char dataFileName[] = "picaria.db";
+
+// The game in progress, journaled on every move and resumed on start.
+static const char journalFileName[] = "picaria.journal";
+
+// Saved games, in PicariaRecord's text or binary format.
+static const char gameFilter[] = "Partidas (*.txt *.pcg);;Todos os arquivos (*)";
 
 Picaria::Picaria(QWidget *parent)
     : QMainWindow(parent),
       ui(new Ui::Picaria),
-      m_mode(Picaria::NineHoles),
-      m_player(Picaria::RedPlayer),
-      m_phase(Picaria::DropPhase),
-      m_dropCount(0),
-      m_selected(nullptr){
+      m_game(PicariaBoard::NineHoles),
+      m_selected(-1),
+      m_worker(nullptr),
+      m_computer{false, false},
+      m_pondering(false),
+      m_hintWanted(false){
 
     ui->setupUi(this);
 
+    this->loadData();
+    m_worker = new PicariaWorker(this->createEngine(false), this);
+
     QActionGroup* modeGroup = new QActionGroup(this);
     modeGroup->setExclusive(true);
     modeGroup->addAction(ui->action9holes);
     modeGroup->addAction(ui->action13holes);
 
+    QActionGroup* engineGroup = new QActionGroup(this);
+    engineGroup->setExclusive(true);
+    engineGroup->addAction(ui->actionEngineSearch);
+    engineGroup->addAction(ui->actionEngineMcts);
+
     QObject::connect(ui->actionNew, SIGNAL(triggered(bool)), this, SLOT(reset()));
+    QObject::connect(ui->actionOpen, SIGNAL(triggered(bool)), this, SLOT(openGame()));
+    QObject::connect(ui->actionSave, SIGNAL(triggered(bool)), this, SLOT(saveGame()));
+    QObject::connect(ui->actionUndo, SIGNAL(triggered(bool)), this, SLOT(undo()));
+    QObject::connect(ui->actionRedo, SIGNAL(triggered(bool)), this, SLOT(redo()));
     QObject::connect(ui->actionQuit, SIGNAL(triggered(bool)), qApp, SLOT(quit()));
     QObject::connect(modeGroup, SIGNAL(triggered(QAction*)), this, SLOT(updateMode(QAction*)));
     QObject::connect(this, SIGNAL(modeChanged(Picaria::Mode)), this, SLOT(reset()));
     QObject::connect(ui->actionAbout, SIGNAL(triggered(bool)), this, SLOT(showAbout()));
-
-    QSignalMapper* map = new QSignalMapper(this);
-    for (int id = 0; id < 13; ++id) {
-        int r;
-        int c;
-        switch(id){
-        case 0: r=0; c=0; break;
-        case 1: r=0; c=1; break;
-        case 2: r=0; c=2; break;
-        case 3: r=1; c=0; break;
-        case 4: r=1; c=1; break;
-        case 5: r=2; c=0; break;
-        case 6: r=2; c=1; break;
-        case 7: r=2; c=2; break;
-        case 8: r=3; c=0; break;
-        case 9: r=3; c=1; break;
-        case 10: r=4; c=0; break;
-        case 11: r=4; c=1; break;
-        case 12: r=4; c=2; break;
-        }
-        QString holeName = QString("hole%1").arg(id+1, 2, 10, QChar('0'));
-        Hole* hole = this->findChild<Hole*>(holeName);
-        Q_ASSERT(hole != nullptr);
-        hole->setRow(r);
-        hole->setCol(c);
-        m_holes[id] = hole;
-        map->setMapping(hole, id);
-        QObject::connect(hole, SIGNAL(clicked(bool)), map, SLOT(map()));
-    }
-#if QT_VERSION < QT_VERSION_CHECK(6,0,0)
-    QObject::connect(map, SIGNAL(mapped(int)), this, SLOT(play(int)));
-#else
-    QObject::connect(map, SIGNAL(mappedInt(int)), this, SLOT(play(int)));
-#endif
-
-    this->reset();
+    QObject::connect(ui->actionComputerRed, SIGNAL(toggled(bool)), this, SLOT(updateComputer()));
+    QObject::connect(ui->actionComputerBlue, SIGNAL(toggled(bool)), this, SLOT(updateComputer()));
+    QObject::connect(engineGroup, SIGNAL(triggered(QAction*)), this, SLOT(updateEngine(QAction*)));
+    QObject::connect(ui->actionHint, SIGNAL(triggered(bool)), this, SLOT(requestHint()));
+    QObject::connect(ui->actionStop, SIGNAL(triggered(bool)), m_worker, SLOT(stop()));
+    QObject::connect(m_worker, SIGNAL(finished(int,PicariaBoard,PicariaMove)),
+                     this, SLOT(engineFinished(int,PicariaBoard,PicariaMove)));
+
+    QObject::connect(ui->board, SIGNAL(clicked(int)), this, SLOT(play(int)));
+
+    // Resume the game the last run left, if any, appending to its journal
+    // in place: rewriting it would put the game at risk. A finished game,
+    // left when the process died on the game over dialog, starts a new
+    // one. Entries are appended on the GUI thread; the journal's flusher
+    // thread groups the syncs.
+    QString directory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(directory);
+    std::string journalPath = QDir::toNativeSeparators(QDir(directory).filePath(journalFileName)).toStdString();
+    PicariaGame restored;
+    bool resumed = PicariaJournal::restore(journalPath, restored);
+    if (!m_journal.open(journalPath))
+        qDebug() << "cannot open the journal" << QString::fromStdString(journalPath);
+
+    if (resumed && !restored.isOver())
+        this->setGame(restored);
+    else
+        this->reset();
 
     this->adjustSize();
     this->setFixedSize(this->size());
@@ -88,77 +108,326 @@ Picaria::~Picaria() {
 }
 
 void Picaria::setMode(Picaria::Mode mode) {
-    if (m_mode != mode) {
-        m_mode = mode;
+    if (this->mode() != mode) {
+        m_game.reset(static_cast<PicariaBoard::Mode>(mode));
         emit modeChanged(mode);
     }
 }
 
 
 void Picaria::switchPlayer() {
-    m_player = m_player == Picaria::RedPlayer ?
-                    Picaria::BluePlayer : Picaria::RedPlayer;
+    this->updateHoles();
+    this->updateHistory();
     this->updateStatusBar();
 }
 
-void Picaria::play(int id) {
-    Hole* hole = m_holes[id];
+void Picaria::updateHoles() {
+    // One diff against the shown board: one repaint, whatever changed.
+    ui->board->setBoard(m_game.board());
+}
+
+void Picaria::updateHistory() {
+    ui->actionUndo->setEnabled(m_game.canUndo());
+    ui->actionRedo->setEnabled(m_game.canRedo());
+}
 
-    qDebug() << "clicked on: " << hole->objectName();
-    switch(m_phase){
-    case Picaria::DropPhase:
-        stateOne(hole);
+void Picaria::play(int id) {
+    qDebug() << "clicked on: " << id + 1;
+    if(this->isComputer(static_cast<Picaria::Player>(m_game.board().player())))
+        return;
+
+    size_t before = m_game.ply();
+    switch(m_game.board().phase()){
+    case PicariaBoard::DropPhase:
+        stateOne(id);
         break;
-    case Picaria::MovePhase:
-        stateTwo(hole);
+    case PicariaBoard::MovePhase:
+        stateTwo(id);
     }
-    if(isGameOver(Picaria::RedPlayer) || isGameOver(Picaria::BluePlayer)){
-        this->switchPlayer();
-        gameOver(m_player);
-     }
+
+    // A move always ends on the clicked hole.
+    if(m_game.ply() != before)
+        this->endMove(id);
 }
 
-void Picaria::stateOne(Hole* hole){
-    if(hole->state()==Hole::EmptyState){
-        hole->setState(player2state(m_player));
-        this->switchPlayer();
-        m_dropCount++;
+void Picaria::endMove(int to) {
+    // Only the lines through the hole the move ended on can have been
+    // completed, and only by the player who moved. A player left without
+    // moves loses as well.
+    PicariaBoard::Player mover = PicariaBoard::opponent(m_game.board().player());
+    if(m_game.board().hasLineThrough(mover, to) || !m_game.board().hasMoves())
+        gameOver(static_cast<Picaria::Player>(mover));
+    else
+        this->scheduleComputer();
+}
+
+void Picaria::scheduleComputer() {
+    // The engine runs on the worker, so the window keeps responding. While
+    // a human plays against it, it ponders on the human's position.
+    // A hint request on the computer's turn would replace its move on the
+    // worker, so hints are only offered on the user's turn.
+    m_pondering = false;
+    m_hintWanted = false;
+    bool computerTurn = this->isComputer(static_cast<Picaria::Player>(m_game.board().player()));
+    ui->actionHint->setEnabled(!computerTurn);
+    if(computerTurn){
+        // Book moves need no search, nor the worker. The move is queued so
+        // that the user's move is shown before the answer.
+        PicariaMove move = this->bookMove();
+        if(!move.isNull()){
+            m_worker->cancel();
+            PicariaBoard board = m_game.board();
+            QMetaObject::invokeMethod(this, [this, board, move]() {
+                this->engineFinished(PicariaWorker::MoveRequest, board, move);
+            }, Qt::QueuedConnection);
+            return;
+        }
+        m_worker->start(PicariaWorker::MoveRequest, m_game.board(), computerTime);
+        QString player(m_game.board().player() == PicariaBoard::RedPlayer ? "vermelho" : "azul");
+        ui->statusbar->showMessage(tr("Computador pensando: vez do jogador %1").arg(player));
+    }
+    else if(m_computer[PicariaBoard::RedPlayer] || m_computer[PicariaBoard::BluePlayer]){
+        m_worker->start(PicariaWorker::PonderRequest, m_game.board(), ponderTime);
+        m_pondering = true;
     }
-    if(m_dropCount==6){
-        m_phase=MovePhase;
-        this->updateStatusBar();
+    else
+        m_worker->cancel();
+}
+
+void Picaria::playComputer(PicariaMove move) {
+    // Showing the new board clears any marks left by the human as well.
+    jogar = false;
+    m_selected = -1;
+
+    m_game.play(move);
+    m_journal.play(move);
+    this->switchPlayer();
+    this->endMove(move.to);
+}
+
+void Picaria::undo() {
+    // Moves of the computer are taken back with the user's move before
+    // them, so that the user is to move again.
+    if(!m_game.canUndo())
+        return;
+    m_game.undo();
+    m_journal.undo();
+    while(m_game.canUndo() && this->isComputer(static_cast<Picaria::Player>(m_game.board().player()))){
+        m_game.undo();
+        m_journal.undo();
     }
 
+    jogar = false;
+    m_selected = -1;
+    this->switchPlayer();
+    this->scheduleComputer();
 }
 
+void Picaria::redo() {
+    // Plays the user's move again, and the computer's answers after it.
+    if(!m_game.canRedo())
+        return;
+    m_game.redo();
+    m_journal.redo();
+    while(m_game.canRedo() && this->isComputer(static_cast<Picaria::Player>(m_game.board().player()))){
+        m_game.redo();
+        m_journal.redo();
+    }
+
+    jogar = false;
+    m_selected = -1;
+    this->switchPlayer();
+    this->scheduleComputer();
+}
 
+void Picaria::openGame() {
+    QString path = QFileDialog::getOpenFileName(this, tr("Abrir partida"), QString(), tr(gameFilter));
+    if(path.isEmpty())
+        return;
+
+    // Only the first game of a file is played.
+    PicariaRecordReader reader;
+    PicariaRecord record;
+    if(!reader.open(QDir::toNativeSeparators(path).toStdString()) || !reader.read(record) ||
+            record.validate() != PicariaRecord::NoError){
+        QMessageBox::warning(this, tr("Abrir partida"), tr("Partida inválida: %1").arg(path));
+        return;
+    }
 
-void Picaria::reset() {
-    // Reset each hole.
-    for (int id = 0; id < 13; ++id) {
-        Hole* hole = m_holes[id];
-        hole->reset();
-
-        // Set the hole visibility according to the board mode.
-        switch (id) {
-            case 3:
-            case 4:
-            case 8:
-            case 9:
-                hole->setVisible(m_mode == Picaria::ThirteenHoles);
-                break;
-            default:
-                break;
+    PicariaGame game(record.mode);
+    m_journal.start(record.mode);
+    for(PicariaMove move : record.moves){
+        game.play(move);
+        m_journal.play(move);
+    }
+    this->setGame(game);
+}
+
+void Picaria::setGame(const PicariaGame& game) {
+    // The mode is set without modeChanged(), which would start a new game.
+    (game.mode() == PicariaBoard::NineHoles ? ui->action9holes : ui->action13holes)->setChecked(true);
+    m_game = game;
+
+    jogar = false;
+    m_selected = -1;
+    m_hint = PicariaMove();
+    m_worker->clear();
+    this->switchPlayer();
+    this->scheduleComputer();
+}
+
+void Picaria::saveGame() {
+    QString path = QFileDialog::getSaveFileName(this, tr("Salvar partida"), QString(), tr(gameFilter));
+    if(path.isEmpty())
+        return;
+
+    // Text unless the binary extension is asked for. Undone moves are
+    // not part of the game.
+    PicariaRecord record;
+    record.mode = m_game.mode();
+    record.moves.assign(m_game.moves().begin(), m_game.moves().begin() + static_cast<std::ptrdiff_t>(m_game.ply()));
+
+    PicariaRecordWriter writer;
+    PicariaRecord::Format format = path.endsWith(".pcg") ? PicariaRecord::BinaryFormat : PicariaRecord::TextFormat;
+    if(!writer.open(QDir::toNativeSeparators(path).toStdString(), format) || !writer.write(record) || !writer.close())
+        QMessageBox::warning(this, tr("Salvar partida"), tr("Não foi possível salvar: %1").arg(path));
+}
+
+void Picaria::requestHint() {
+    if(this->isComputer(static_cast<Picaria::Player>(m_game.board().player())))
+        return;
+
+    PicariaMove move = this->bookMove();
+    if(!move.isNull()){
+        m_hintBoard = m_game.board();
+        m_hint = move;
+    }
+
+    if(m_hintBoard == m_game.board() && !m_hint.isNull())
+        this->showHint();
+    else if(m_pondering){
+        // The ponder search is already on this position: cut it short.
+        m_hintWanted = true;
+        m_worker->stop();
+    }
+    else {
+        m_worker->start(PicariaWorker::HintRequest, m_game.board(), hintTime);
+        ui->statusbar->showMessage(tr("Calculando dica..."));
+    }
+}
+
+PicariaMove Picaria::bookMove() const {
+    if(!m_book || m_game.isOver())
+        return PicariaMove();
+    return m_book->move(m_game.board());
+}
+
+void Picaria::showHint() {
+    if(m_hint.isDrop())
+        ui->statusbar->showMessage(tr("Dica: colocar no buraco %1").arg(m_hint.to + 1));
+    else
+        ui->statusbar->showMessage(tr("Dica: mover do buraco %1 para o %2").arg(m_hint.from + 1).arg(m_hint.to + 1));
+}
+
+void Picaria::engineFinished(int request, const PicariaBoard& board, PicariaMove move) {
+    // Results for any other position are stale.
+    if(board != m_game.board() || move.isNull())
+        return;
+
+    switch(request){
+    case PicariaWorker::MoveRequest:
+        if(this->isComputer(static_cast<Picaria::Player>(m_game.board().player())))
+            this->playComputer(move);
+        break;
+    case PicariaWorker::HintRequest:
+        m_hintBoard = board;
+        m_hint = move;
+        this->showHint();
+        break;
+    case PicariaWorker::PonderRequest:
+        // Kept for an instant hint.
+        m_pondering = false;
+        m_hintBoard = board;
+        m_hint = move;
+        if(m_hintWanted)
+            this->showHint();
+        m_hintWanted = false;
+        break;
+    }
+}
+
+void Picaria::updateEngine(QAction* action) {
+    if (action == ui->actionEngineSearch)
+        m_worker->setEngine(this->createEngine(false));
+    else if (action == ui->actionEngineMcts)
+        m_worker->setEngine(this->createEngine(true));
+    else
+        Q_UNREACHABLE();
+    this->scheduleComputer();
+}
+
+std::shared_ptr<const PicariaDataFile> Picaria::openDataFile() {
+    // The file is mapped, so its pages are shared with other processes,
+    // but opening still checks the checksum of every section: the time
+    // grows with the size of the file.
+    QString paths[] = {
+        QDir(QCoreApplication::applicationDirPath()).filePath(dataFileName),
+        QDir::current().filePath(dataFileName)
+    };
+    for (const QString& path : paths) {
+        std::shared_ptr<const PicariaDataFile> file = PicariaDataFile::open(QDir::toNativeSeparators(path).toStdString());
+        if (file) {
+            qDebug() << "loaded" << path;
+            return file;
         }
     }
+    return nullptr;
+}
+
+void Picaria::loadData() {
+    PicariaDataFile::load(Picaria::openDataFile(), m_tablebase, m_book);
+}
+
+PicariaEngine* Picaria::createEngine(bool mcts) const {
+    PicariaEngine* engine = mcts ? static_cast<PicariaEngine*>(new PicariaMcts) : new PicariaSearch(4 << 20, 0);
+    // Without a data file, the search plays everything.
+    if (!m_tablebase && !m_book)
+        return engine;
+    return new PicariaOracle(engine, m_tablebase, m_book);
+}
+
+void Picaria::updateComputer() {
+    m_computer[PicariaBoard::RedPlayer] = ui->actionComputerRed->isChecked();
+    m_computer[PicariaBoard::BluePlayer] = ui->actionComputerBlue->isChecked();
+    this->scheduleComputer();
+}
+
+void Picaria::stateOne(int id){
+    if(m_game.play(PicariaMove::drop(id))){
+        m_journal.play(PicariaMove::drop(id));
+        this->switchPlayer();
+    }
+}
 
-    // Reset the player and phase.
-    m_player = Picaria::RedPlayer;
-    m_phase = Picaria::DropPhase;
-    m_dropCount=0;
 
-    // Finally, update the status bar.
+
+void Picaria::reset() {
+    // Reset the board and the move history: player, phase and drop count
+    // included.
+    m_game.reset(m_game.mode());
+    m_journal.start(m_game.mode());
+    m_selected = -1;
+    jogar = false;
+
+    // Reset each hole, showing the holes of the board mode.
+    ui->board->setBoard(m_game.board());
+    this->updateHistory();
+    m_worker->clear();
+    m_hint = PicariaMove();
+
+    // Finally, update the status bar and let the computer open if it plays red.
     this->updateStatusBar();
+    this->scheduleComputer();
 }
 
 void Picaria::showAbout() {
@@ -175,602 +444,45 @@ void Picaria::updateMode(QAction* action) {
 }
 
 void Picaria::updateStatusBar() {
-    QString player(m_player == Picaria::RedPlayer ? "vermelho" : "azul");
-    QString phase(m_phase == Picaria::DropPhase ? "colocar" : "mover");
+    QString player(m_game.board().player() == PicariaBoard::RedPlayer ? "vermelho" : "azul");
+    QString phase(m_game.board().phase() == PicariaBoard::DropPhase ? "colocar" : "mover");
 
     ui->statusbar->showMessage(tr("Fase de %1: vez do jogador %2").arg(phase).arg(player));
 }
 
-bool isSelectable(Hole* hole){
-    return hole!=nullptr && (hole->state()==Hole::EmptyState || hole->state()==Hole::SelectableState);
-}
+QList<int> Picaria::findSelectable(int id){
+    QList<int> list;
 
-QList<Hole*> Picaria::findSelectable(Hole* hole){
-    QList<Hole*> list;
-    int id;
-    switch(hole->row()){
-    case 0: id = hole->col();break;
-    case 1: id = 3 + hole->col();break;
-    case 2: id = 5 + hole->col();break;
-    case 3: id = 8 + hole->col();break;
-    case 4: id = 10 + hole->col();break;
+    uint16_t destinations = m_game.board().destinations(id);
+    for (int to = 0; to < 13; ++to) {
+        if (destinations & (1u << to))
+            list << to;
     }
+    ui->board->setBoard(m_game.board(), destinations);
 
-    //qDebug() << "Row"<< hole->row() << "col"<< hole->col() << "id" <<id;
-
-    if(m_mode == Picaria::NineHoles){
-        switch (id)
-        {
-        case 0:
-
-            if (isSelectable(holeAt(1)))
-            { //1
-                holeAt(1)->setState(Hole::SelectableState);
-                list << holeAt(1);
-            }
-
-            if (isSelectable(holeAt(5)))
-            { //5
-                holeAt(5)-> setState(Hole::SelectableState);
-                list << holeAt(5);
-            }
-            if (isSelectable(holeAt(6)))
-            { //6
-                holeAt(6)->setState(Hole::SelectableState);
-                list << holeAt(6);
-            }
-            break;
-        case 1:
-            if (isSelectable(holeAt(0)))
-            { //0
-                holeAt(0)->setState(Hole::SelectableState);
-                list << holeAt(0);
-            }
-            if (isSelectable(holeAt(2)))
-            { //2
-                holeAt(2)->setState(Hole::SelectableState);
-                list << holeAt(2);
-            }
-            if (isSelectable(holeAt(5)))
-            { //5
-                holeAt(5)->setState(Hole::SelectableState);
-                list << holeAt(5);
-            }
-            if (isSelectable(holeAt(6)))
-            { //6
-                holeAt(6)->setState(Hole::SelectableState);
-                list << holeAt(6);
-            }
-            if (isSelectable(holeAt(7)))
-            { //7
-                holeAt(7)->setState(Hole::SelectableState);
-                list << holeAt(7);
-            }
-            break;
-        case 2:
-            if (isSelectable(holeAt(6)))
-            { //6
-                holeAt(6)->setState(Hole::SelectableState);
-                list << holeAt(6);
-            }
-            if (isSelectable(holeAt(1)))
-            { //1
-                holeAt(1)->setState(Hole::SelectableState);
-                list << holeAt(1);
-            }
-            if (isSelectable(holeAt(7)))
-            { //7
-
-          holeAt(7)-> setState(Hole::SelectableState);
-          list << holeAt(7);
-            }
-            break;
-        case 5:
-            if (isSelectable(holeAt(0)))
-            { //0
-                holeAt(0)->setState(Hole::SelectableState);
-                list << holeAt(0);
-            }
-            if (isSelectable(holeAt(1)))
-            { //1
-                holeAt(1)->setState(Hole::SelectableState);
-                list << holeAt(1);
-            }
-            if (isSelectable(holeAt(6)))
-            { //6
-                holeAt(6)->setState(Hole::SelectableState);
-                list << holeAt(6);
-            }
-            if (isSelectable(holeAt(10)))
-            { //10
-                holeAt(10)->setState(Hole::SelectableState);
-                list << holeAt(10);
-            }
-            if (isSelectable(holeAt(11)))
-            { //11
-                holeAt(11)->setState(Hole::SelectableState);
-                list << holeAt(11);
-            }
-            break;
-        case 6:
-            if (isSelectable(holeAt(0)))
-            { //0
-                holeAt(0)->setState(Hole::SelectableState);
-                list << holeAt(0);
-            }
-            if (isSelectable(holeAt(1)))
-            { //1
-                holeAt(1)->setState(Hole::SelectableState);
-                list << holeAt(1);
-            }
-            if (isSelectable(holeAt(2)))
-            { //2
-                holeAt(2)->setState(Hole::SelectableState);
-                list << holeAt(2);
-            }
-            if (isSelectable(holeAt(5)))
-            { //5
-                holeAt(5)->setState(Hole::SelectableState);
-                list << holeAt(5);
-            }
-            if (isSelectable(holeAt(7)))
-            { //7
-                holeAt(7)->setState(Hole::SelectableState);
-                list << holeAt(7);
-            }
-            if (isSelectable(holeAt(10)))
-            { //10
-                holeAt(10)->setState(Hole::SelectableState);
-                list << holeAt(10);
-            }
-            if (isSelectable(holeAt(11)))
-            { //11
-                holeAt(11)->setState(Hole::SelectableState);
-                list << holeAt(11);
-            }
-            if (isSelectable(holeAt(12)))
-            { //12
-                holeAt(12)->setState(Hole::SelectableState);
-                list << holeAt(12);
-            }
-            break;
-        case 7:
-            if (isSelectable(holeAt(1)))
-            { //1
-                holeAt(1)->setState(Hole::SelectableState);
-                list << holeAt(1);
-            }
-            if (isSelectable(holeAt(2)))
-            { //2
-                        holeAt(2)-> setState(Hole::SelectableState);
-                        list << holeAt(2);
-            }
-            if (isSelectable(holeAt(6)))
-            { //6
-                holeAt(6)->setState(Hole::SelectableState);
-                list << holeAt(6);
-            }
-            if (isSelectable(holeAt(11)))
-            { //11
-                holeAt(11)->setState(Hole::SelectableState);
-                list << holeAt(11);
-            }
-            if (isSelectable(holeAt(12)))
-            { //12
-                        holeAt(12)-> setState(Hole::SelectableState);
-                        list << holeAt(12);
-            }
-            break;
-        case 10:
-            if (isSelectable(holeAt(5)))
-            { //5
-                holeAt(5)->setState(Hole::SelectableState);
-                list << holeAt(5);
-            }
-            if (isSelectable(holeAt(6)))
-            { //6
-                holeAt(6)->setState(Hole::SelectableState);
-                list << holeAt(6);
-            }
-            if (isSelectable(holeAt(11)))
-            { //11
-                holeAt(11)->setState(Hole::SelectableState);
-                list << holeAt(11);
-            }
-            break;
-        case 11:
-            if (isSelectable(holeAt(5)))
-            { //5
-                holeAt(5)->setState(Hole::SelectableState);
-                list << holeAt(5);
-            }
-            if (isSelectable(holeAt(6)))
-            { //6
-                holeAt(6)->setState(Hole::SelectableState);
-                list << holeAt(6);
-            }
-            if (isSelectable(holeAt(7)))
-            { //7
-                holeAt(7)->setState(Hole::SelectableState);
-                list << holeAt(7);
-            }
-            if (isSelectable(holeAt(10)))
-            { //10
-                holeAt(10)->setState(Hole::SelectableState);
-                list << holeAt(10);
-            }
-            if (isSelectable(holeAt(12)))
-            { //12
-                holeAt(12)->setState(Hole::SelectableState);
-                list << holeAt(12);
-            }
-            break;
-        case 12:
-            if (isSelectable(holeAt(6)))
-            { //6
-                holeAt(6)->setState(Hole::SelectableState);
-                list << holeAt(6);
-            }
-            if (isSelectable(holeAt(7)))
-            { //7
-                holeAt(7)->setState(Hole::SelectableState);
-                list << holeAt(7);
-            }
-            if (isSelectable(holeAt(11)))
-            { //11
-                holeAt(11)->setState(Hole::SelectableState);
-                list << holeAt(11);
-            }
-            break;
-
-        }
-
-    }
-    else{
-        switch (id)
-               {
-               case 0:
-                   if (isSelectable(holeAt(1)))
-                   { //1
-                       holeAt(1)->setState(Hole::SelectableState);
-                       list << holeAt(1);
-                   }
-
-                   if (isSelectable(holeAt(5)))
-                   { //5
-                       holeAt(5)-> setState(Hole::SelectableState);
-                       list << holeAt(5);
-                   }
-                   if (isSelectable(holeAt(3)))
-                   { //3
-                       holeAt(3)->setState(Hole::SelectableState);
-                       list << holeAt(3);
-                   }
-                   break;
-               case 1:
-                   if (isSelectable(holeAt(0)))
-                   { //0
-                       holeAt(0)->setState(Hole::SelectableState);
-                       list << holeAt(0);
-                   }
-                   if (isSelectable(holeAt(2)))
-                   { //2
-                       holeAt(2)->setState(Hole::SelectableState);
-                       list << holeAt(2);
-                   }
-                   if (isSelectable(holeAt(3)))
-                   { //3
-                       holeAt(3)->setState(Hole::SelectableState);
-                       list << holeAt(3);
-                   }
-                   if (isSelectable(holeAt(6)))
-                   { //6
-                       holeAt(6)->setState(Hole::SelectableState);
-                       list << holeAt(6);
-                   }
-                   if (isSelectable(holeAt(4)))
-                   { //4
-                       holeAt(4)->setState(Hole::SelectableState);
-                       list << holeAt(4);
-                   }
-                   break;
-               case 2:
-                   if (isSelectable(holeAt(4)))
-                   { //4
-                       holeAt(4)->setState(Hole::SelectableState);
-                       list << holeAt(4);
-                   }
-                   if (isSelectable(holeAt(1)))
-                   { //1
-                       holeAt(1)->setState(Hole::SelectableState);
-                       list << holeAt(1);
-                   }
-                   if (isSelectable(holeAt(7)))
-                   { //7
-
-                 holeAt(7)-> setState(Hole::SelectableState);
-                 list << holeAt(7);
-                   }
-                   break;
-               case 3:
-                   if (isSelectable(holeAt(0)))
-                   { //0
-                       holeAt(0)->setState(Hole::SelectableState);
-                       list << holeAt(0);
-                   }
-                   if (isSelectable(holeAt(1)))
-                   { //1
-                       holeAt(1)->setState(Hole::SelectableState);
-                       list << holeAt(1);
-                   }
-                   if (isSelectable(holeAt(5)))
-                   { //5
-                       holeAt(5)-> setState(Hole::SelectableState);
-                       list << holeAt(5);
-                   }
-                   if (isSelectable(holeAt(6)))
-                   { //6
-                       holeAt(6)-> setState(Hole::SelectableState);
-                       list << holeAt(6);
-                   }
-                   break;
-               case 4:
-                   if (isSelectable(holeAt(2)))
-                   { //2
-                       holeAt(2)->setState(Hole::SelectableState);
-                       list << holeAt(2);
-                   }
-                   if (isSelectable(holeAt(1)))
-                   { //1
-                       holeAt(1)->setState(Hole::SelectableState);
-                       list << holeAt(1);
-                   }
-                   if (isSelectable(holeAt(7)))
-                   { //7
-                       holeAt(7)-> setState(Hole::SelectableState);
-                       list << holeAt(7);
-                   }
-                   if (isSelectable(holeAt(6)))
-                   { //6
-                       holeAt(6)-> setState(Hole::SelectableState);
-                       list << holeAt(6);
-                   }
-                   break;
-               case 5:
-                   if (isSelectable(holeAt(0)))
-                   { //0
-                       holeAt(0)->setState(Hole::SelectableState);
-                       list << holeAt(0);
-                   }
-                   if (isSelectable(holeAt(3)))
-                   { //3
-                       holeAt(3)->setState(Hole::SelectableState);
-                       list << holeAt(3);
-                   }
-                   if (isSelectable(holeAt(6)))
-                   { //6
-                       holeAt(6)->setState(Hole::SelectableState);
-                       list << holeAt(6);
-                   }
-                   if (isSelectable(holeAt(10)))
-                   { //10
-                       holeAt(10)->setState(Hole::SelectableState);
-                       list << holeAt(10);
-                   }
-                   if (isSelectable(holeAt(8)))
-                   { //8
-                       holeAt(8)->setState(Hole::SelectableState);
-                       list << holeAt(8);
-                   }
-                   break;
-               case 6:
-                   if (isSelectable(holeAt(1)))
-                   { //1
-                       holeAt(1)->setState(Hole::SelectableState);
-                       list << holeAt(1);
-                   }
-                   if (isSelectable(holeAt(4)))
-                   { //4
-                       holeAt(4)->setState(Hole::SelectableState);
-                       list << holeAt(4);
-                   }
-                   if (isSelectable(holeAt(7)))
-                   { //7
-                       holeAt(7)->setState(Hole::SelectableState);
-                       list << holeAt(7);
-                   }
-                   if (isSelectable(holeAt(9)))
-                   { //9
-                       holeAt(9)->setState(Hole::SelectableState);
-                       list << holeAt(9);
-                   }
-                   if (isSelectable(holeAt(11)))
-                   { //11
-                       holeAt(11)->setState(Hole::SelectableState);
-                       list << holeAt(11);
-                   }
-                   if (isSelectable(holeAt(8)))
-                   { //8
-                       holeAt(8)->setState(Hole::SelectableState);
-                       list << holeAt(8);
-                   }
-                   if (isSelectable(holeAt(5)))
-                   { //5
-                       holeAt(5)->setState(Hole::SelectableState);
-                       list << holeAt(5);
-                   }
-                   if (isSelectable(holeAt(3)))
-                   { //3
-                       holeAt(3)->setState(Hole::SelectableState);
-                       list << holeAt(3);
-                   }
-                   break;
-               case 7:
-                   if (isSelectable(holeAt(4)))
-                   { //4
-                       holeAt(4)->setState(Hole::SelectableState);
-                       list << holeAt(4);
-                   }
-                   if (isSelectable(holeAt(2)))
-                   { //2
-                               holeAt(2)-> setState(Hole::SelectableState);
-                               list << holeAt(2);
-                   }
-                   if (isSelectable(holeAt(6)))
-                   { //6
-                       holeAt(6)->setState(Hole::SelectableState);
-                       list << holeAt(6);
-                   }
-                   if (isSelectable(holeAt(9)))
-                   { //9
-                       holeAt(9)->setState(Hole::SelectableState);
-                       list << holeAt(9);
-                   }
-                   if (isSelectable(holeAt(12)))
-                   { //12
-                               holeAt(12)-> setState(Hole::SelectableState);
-                               list << holeAt(12);
-                   }
-                   break;
-            case 8:
-                if (isSelectable(holeAt(5)))
-                { //5
-                    holeAt(5)->setState(Hole::SelectableState);
-                    list << holeAt(5);
-                }
-                if (isSelectable(holeAt(6)))
-                { //6
-                    holeAt(6)->setState(Hole::SelectableState);
-                    list << holeAt(6);
-                }
-                if (isSelectable(holeAt(10)))
-                { //10
-                    holeAt(10)-> setState(Hole::SelectableState);
-                    list << holeAt(10);
-                }
-                if (isSelectable(holeAt(11)))
-                { //11
-                    holeAt(11)-> setState(Hole::SelectableState);
-                    list << holeAt(11);
-                }
-                break;
-            case 9:
-                if (isSelectable(holeAt(6)))
-                { //6
-                    holeAt(6)->setState(Hole::SelectableState);
-                    list << holeAt(6);
-                }
-                if (isSelectable(holeAt(11)))
-                { //11
-                    holeAt(11)->setState(Hole::SelectableState);
-                    list << holeAt(11);
-                }
-                if (isSelectable(holeAt(7)))
-                { //7
-                    holeAt(7)-> setState(Hole::SelectableState);
-                    list << holeAt(7);
-                }
-                if (isSelectable(holeAt(12)))
-                { //12
-                    holeAt(12)-> setState(Hole::SelectableState);
-                    list << holeAt(12);
-                }
-                break;
-               case 10:
-                   if (isSelectable(holeAt(5)))
-                   { //5
-                       holeAt(5)->setState(Hole::SelectableState);
-                       list << holeAt(5);
-                   }
-                   if (isSelectable(holeAt(8)))
-                   { //8
-                       holeAt(8)->setState(Hole::SelectableState);
-                       list << holeAt(8);
-                   }
-                   if (isSelectable(holeAt(11)))
-                   { //11
-                       holeAt(11)->setState(Hole::SelectableState);
-                       list << holeAt(11);
-                   }
-                   break;
-               case 11:
-                   if (isSelectable(holeAt(8)))
-                   { //8
-                       holeAt(8)->setState(Hole::SelectableState);
-                       list << holeAt(8);
-                   }
-                   if (isSelectable(holeAt(6)))
-                   { //6
-                       holeAt(6)->setState(Hole::SelectableState);
-                       list << holeAt(6);
-                   }
-                   if (isSelectable(holeAt(9)))
-                   { //9
-                       holeAt(9)->setState(Hole::SelectableState);
-                       list << holeAt(9);
-                   }
-                   if (isSelectable(holeAt(10)))
-                   { //10
-                       holeAt(10)->setState(Hole::SelectableState);
-                       list << holeAt(10);
-                   }
-                   if (isSelectable(holeAt(12)))
-                   { //12
-                       holeAt(12)->setState(Hole::SelectableState);
-                       list << holeAt(12);
-                   }
-                   break;
-               case 12:
-                   if (isSelectable(holeAt(9)))
-                   { //9
-                       holeAt(9)->setState(Hole::SelectableState);
-                       list << holeAt(9);
-                   }
-                   if (isSelectable(holeAt(7)))
-                   { //7
-                       holeAt(7)->setState(Hole::SelectableState);
-                       list << holeAt(7);
-                   }
-                   if (isSelectable(holeAt(11)))
-                   { //11
-                       holeAt(11)->setState(Hole::SelectableState);
-                       list << holeAt(11);
-                   }
-                   break;
-
-               }
-    }
     return list;
 }
 
+void Picaria::stateTwo(int id){
+    qDebug() << m_game.board().player();
 
-
-Hole* Picaria::holeAt(int index){
-        return m_holes[index];
-}
-
-void Picaria::stateTwo(Hole *hole){
-    qDebug() << m_player;
-
-        QList<Hole*>  selectable;
-        if(hole->state() == player2state(m_player)){
+        QList<int>  selectable;
+        if(m_game.board().hasPiece(m_game.board().player(), id)){
             jogar = true;
-            selectable = this->findSelectable(hole);
+            selectable = this->findSelectable(id);
             qDebug() << selectable;
-            m_selected = hole;
+            m_selected = id;
         }
         else if(jogar){
             jogar = false;
-            if(hole->state()==Hole::SelectableState){
-                hole->setState(player2state(m_player));
-                hole=m_selected;
-                hole->setState(Hole::EmptyState);
-                this->clearSelectable();
+            if(ui->board->state(id)==BoardView::SelectableState && m_game.play(PicariaMove::slide(m_selected, id))){
+                m_journal.play(PicariaMove::slide(m_selected, id));
+                m_selected = -1;
                 this->switchPlayer();
             }
             else{
                 jogar = false;
-                QString player(m_player == Picaria::RedPlayer ? "vermelho" : "azul");
+                QString player(m_game.board().player() == PicariaBoard::RedPlayer ? "vermelho" : "azul");
                 ui->statusbar->showMessage(tr("Buraco incorreto. Escolha a peça e tente novamente jogador %1").arg(player));
                 this->clearSelectable();
             }
@@ -779,99 +491,11 @@ void Picaria::stateTwo(Hole *hole){
 }
 
 void Picaria::clearSelectable(){
-    for (int id=0; id<13; id++) {
-        Hole* hole = m_holes[id];
-        if(hole->state()==Hole::SelectableState){
-            hole->setState(Hole::EmptyState);
-        }
-    }
+    ui->board->setBoard(m_game.board());
 }
 
 bool Picaria::isGameOver(Player player){
-    return this->checkRow(player) || this->checkCol(player) ||
-               this->checkDiagonal(player) || this->checkAntiDiagonal(player);
-}
-
-bool Picaria::checkCol(Player player){
-    Hole::State state = player2state(player);
-    for (int i=0;i<3 ;i++ ) {
-        if(holeAt(0+i)->state()==state &&
-                holeAt(5+i)->state()==state &&
-                holeAt(10+i)->state()==state){
-            return true;
-        }
-    }
-    return false;
-}
-
-bool Picaria::checkRow(Player player){
-    Hole::State state = player2state(player);
-    for (int i=0;i<13 ;i+=5 ) {
-        if(holeAt(0+i)->state()==state &&
-                holeAt(1+i)->state()==state &&
-                holeAt(2+i)->state()==state){
-            return true;
-        }
-    }
-    return false;
-}
-
-bool Picaria::checkDiagonal(Player player){
-    Hole::State state = player2state(player);
-    if(m_mode==Picaria::NineHoles){
-        if(holeAt(0)->state()==state &&
-                holeAt(6)->state()==state &&
-                holeAt(12)->state()==state)
-            return true;
-    }
-    else{
-        for (int i=0;i<13 ;i+=3) {
-            if(holeAt(0+i)->state()==state &&
-                    holeAt(3+i)->state()==state &&
-                    holeAt(6+i)->state()==state)
-                return true;
-        }
-        if(holeAt(5)->state()==state &&
-                holeAt(8)->state()==state &&
-                holeAt(11)->state()==state)
-            return true;
-        else{
-            if(holeAt(1)->state()==state &&
-                holeAt(4)->state()==state &&
-                holeAt(7)->state()==state)
-            return true;
-        }
-    }
-    return false;
-}
-
-bool Picaria::checkAntiDiagonal(Player player){
-    Hole::State state = player2state(player);
-    if(m_mode==Picaria::NineHoles){
-        if(holeAt(2)->state()==state &&
-                holeAt(6)->state()==state &&
-                holeAt(10)->state()==state)
-            return true;
-    }
-    else{
-        for (int i=2;i<9 ;i+=2) {
-            if(holeAt(0+i)->state()==state &&
-                    holeAt(2+i)->state()==state &&
-                    holeAt(4+i)->state()==state)
-                return true;
-        }
-        if(holeAt(1)->state()==state &&
-                holeAt(3)->state()==state &&
-                holeAt(5)->state()==state)
-            return true;
-        else{
-            if(holeAt(7)->state()==state &&
-                holeAt(9)->state()==state &&
-                holeAt(11)->state()==state)
-            return true;
-        }
-    }
-    return false;
+    return m_game.board().hasLine(static_cast<PicariaBoard::Player>(player));
 }
 
 void Picaria::gameOver(Player player){
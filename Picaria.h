@@ -3,13 +3,22 @@
 
 #include <QMainWindow>
 
+#include <memory>
+
+#include "PicariaGame.h"
+#include "PicariaJournal.h"
+
 QT_BEGIN_NAMESPACE
 namespace Ui {
     class Picaria;
 }
 QT_END_NAMESPACE
 
-class Hole;
+class PicariaBook;
+class PicariaDataFile;
+class PicariaEngine;
+class PicariaTablebase;
+class PicariaWorker;
 
 class Picaria : public QMainWindow {
     Q_OBJECT
@@ -17,20 +26,20 @@ class Picaria : public QMainWindow {
 
 public:
     enum Mode {
-        NineHoles,
-        ThirteenHoles
+        NineHoles = PicariaBoard::NineHoles,
+        ThirteenHoles = PicariaBoard::ThirteenHoles
     };
     Q_ENUM(Mode)
 
     enum Player {
-        RedPlayer,
-        BluePlayer
+        RedPlayer = PicariaBoard::RedPlayer,
+        BluePlayer = PicariaBoard::BluePlayer
     };
     Q_ENUM(Player)
 
     enum Phase {
-        DropPhase,
-        MovePhase
+        DropPhase = PicariaBoard::DropPhase,
+        MovePhase = PicariaBoard::MovePhase
     };
     Q_ENUM(Phase)
 
@@ -39,24 +48,25 @@ public:
 
     bool jogar = false;
 
-    Picaria::Mode mode() const { return m_mode; }
+    Picaria::Mode mode() const { return static_cast<Picaria::Mode>(m_game.mode()); }
+    const PicariaBoard& board() const { return m_game.board(); }
+    const PicariaGame& game() const { return m_game; }
     void setMode(Picaria::Mode mode);
 
-    Hole* holeAt(int index);
-    QList<Hole*> findSelectable(Hole* hole);
+    // picaria.db next to the executable or in the working directory, or
+    // null. Needs a QCoreApplication.
+    static std::shared_ptr<const PicariaDataFile> openDataFile();
+
+    QList<int> findSelectable(int id);
 
-    //void move(Hole* hole);
     void clearSelectable();
 
     bool isGameOver(Player player);
+    bool isComputer(Player player) const { return m_computer[player]; }
 
-    bool checkRow(Player player);
-    bool checkCol(Player player);
-    bool checkAntiDiagonal(Player player);
-    bool checkDiagonal(Player player);
     void gameOver(Player player);
-    void stateOne(Hole* hole);
-    void stateTwo(Hole* hole);
+    void stateOne(int id);
+    void stateTwo(int id);
 
 
 signals:
@@ -64,24 +74,48 @@ signals:
 
 private:
     Ui::Picaria *ui;
-    Hole* m_holes[13];
-    Mode m_mode;
-    Player m_player;
-    Phase m_phase;
-    int m_dropCount;
-    Hole* m_selected;
+    PicariaGame m_game;
+    PicariaJournal m_journal;
+    int m_selected;
+    PicariaWorker* m_worker;
+    bool m_computer[2];
+    PicariaBoard m_hintBoard;
+    PicariaMove m_hint;
+    bool m_pondering;
+    bool m_hintWanted;
+    std::shared_ptr<const PicariaTablebase> m_tablebase;
+    std::shared_ptr<const PicariaBook> m_book;
 
     void switchPlayer();
+    void updateHoles();
+    void updateHistory();
+    void endMove(int to);
+    void scheduleComputer();
+    void playComputer(PicariaMove move);
+    void setGame(const PicariaGame& game);
+    PicariaMove bookMove() const;
+    void showHint();
+    void loadData();
+    PicariaEngine* createEngine(bool mcts) const;
 
 private slots:
     void play(int id);
     void reset();
+    void undo();
+    void redo();
+    void openGame();
+    void saveGame();
 
     void showAbout();
 
     void updateMode(QAction* action);
     void updateStatusBar();
 
+    void updateComputer();
+    void updateEngine(QAction* action);
+    void requestHint();
+    void engineFinished(int request, const PicariaBoard& board, PicariaMove move);
+
 };
 
 #endif // PICARIA_H
@@ -2,7 +2,7 @@ QT       += core gui
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
-CONFIG += c++11
+CONFIG += c++17
 
 # The following define makes your compiler emit warnings if you use
 # any Qt feature that has been marked deprecated (the exact warnings
@@ -16,13 +16,17 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
-    Hole.cpp \
+    BoardView.cpp \
     main.cpp \
-    Picaria.cpp
+    Picaria.cpp \
+    PicariaWorker.cpp
 
 HEADERS += \
-    Hole.h \
-    Picaria.h
+    BoardView.h \
+    Picaria.h \
+    PicariaWorker.h
+
+include(PicariaCore.pri)
 
 FORMS += \
     Picaria.ui
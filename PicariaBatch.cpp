@@ -0,0 +1,274 @@
+#include "PicariaBatch.h"
+#include "PicariaRules.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PICARIA_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Weight of an open two (two pieces of a line whose third hole is empty),
+// as in PicariaSearch::evaluate. Each hole a player could play to counts 1.
+const int openTwoScore = 30;
+
+template <PicariaBoard::Mode M>
+void evaluateScalar(const PicariaBatch::Positions& positions, const PicariaBatch::Results& results, size_t begin) {
+    typedef PicariaRules<M> Rules;
+
+    for (size_t i = begin; i < positions.count; ++i) {
+        const uint16_t red = positions.red[i];
+        const uint16_t blue = positions.blue[i];
+        const uint16_t occupied = red | blue;
+        const PicariaBoard::Phase phase = __builtin_popcount(occupied) < PicariaBoard::MaxDrops ?
+                    PicariaBoard::DropPhase : PicariaBoard::MovePhase;
+
+        int twos = 0;
+        for (int line = 0; line < Rules::lineCount; ++line) {
+            uint16_t mask = Rules::line(line);
+            if (!(blue & mask) && __builtin_popcount(red & mask) == 2)
+                ++twos;
+            else if (!(red & mask) && __builtin_popcount(blue & mask) == 2)
+                --twos;
+        }
+        int redMobility = __builtin_popcount(Rules::targets(red, occupied, phase));
+        int blueMobility = __builtin_popcount(Rules::targets(blue, occupied, phase));
+        int score = openTwoScore * twos + redMobility - blueMobility;
+
+        if (results.lines)
+            results.lines[i] = static_cast<uint8_t>((Rules::hasLine(red) ? PicariaBatch::RedLine : 0) |
+                                                    (Rules::hasLine(blue) ? PicariaBatch::BlueLine : 0));
+        if (results.redMobility)
+            results.redMobility[i] = static_cast<uint8_t>(redMobility);
+        if (results.blueMobility)
+            results.blueMobility[i] = static_cast<uint8_t>(blueMobility);
+        if (results.scores)
+            results.scores[i] = static_cast<int16_t>(positions.player[i] == PicariaBoard::RedPlayer ? score : -score);
+    }
+}
+
+#ifdef PICARIA_X86
+
+// The vector kernels work on sixteen bit lanes, one position each, and
+// follow the scalar kernel step by step: comparisons give all ones lanes,
+// and subtracting those counts.
+
+__attribute__((target("sse2")))
+inline __m128i popcount(__m128i x) {
+    x = _mm_sub_epi16(x, _mm_and_si128(_mm_srli_epi16(x, 1), _mm_set1_epi16(0x5555)));
+    x = _mm_add_epi16(_mm_and_si128(x, _mm_set1_epi16(0x3333)), _mm_and_si128(_mm_srli_epi16(x, 2), _mm_set1_epi16(0x3333)));
+    x = _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 4)), _mm_set1_epi16(0x0f0f));
+    return _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), _mm_set1_epi16(0x1f));
+}
+
+template <PicariaBoard::Mode M>
+__attribute__((target("sse2")))
+size_t evaluateSse2(const PicariaBatch::Positions& positions, const PicariaBatch::Results& results) {
+    typedef PicariaRules<M> Rules;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i holes = _mm_set1_epi16(static_cast<short>(Rules::holes));
+
+    size_t i = 0;
+    for (; i + 8 <= positions.count; i += 8) {
+        const __m128i red = _mm_loadu_si128(reinterpret_cast<const __m128i*>(positions.red + i));
+        const __m128i blue = _mm_loadu_si128(reinterpret_cast<const __m128i*>(positions.blue + i));
+        const __m128i player = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(positions.player + i)), zero);
+        const __m128i occupied = _mm_or_si128(red, blue);
+        const __m128i drop = _mm_cmplt_epi16(popcount(occupied), _mm_set1_epi16(PicariaBoard::MaxDrops));
+
+        __m128i redLine = zero;
+        __m128i blueLine = zero;
+        __m128i twos = zero;
+        for (int line = 0; line < Rules::lineCount; ++line) {
+            const __m128i mask = _mm_set1_epi16(static_cast<short>(Rules::line(line)));
+            const __m128i r = _mm_and_si128(red, mask);
+            const __m128i b = _mm_and_si128(blue, mask);
+            const __m128i redFull = _mm_cmpeq_epi16(r, mask);
+            const __m128i blueFull = _mm_cmpeq_epi16(b, mask);
+            redLine = _mm_or_si128(redLine, redFull);
+            blueLine = _mm_or_si128(blueLine, blueFull);
+
+            // At most one piece in the line when clearing the lowest
+            // leaves nothing.
+            const __m128i redFew = _mm_or_si128(_mm_cmpeq_epi16(_mm_and_si128(r, _mm_sub_epi16(r, one)), zero), redFull);
+            const __m128i blueFew = _mm_or_si128(_mm_cmpeq_epi16(_mm_and_si128(b, _mm_sub_epi16(b, one)), zero), blueFull);
+            twos = _mm_sub_epi16(twos, _mm_andnot_si128(redFew, _mm_cmpeq_epi16(b, zero)));
+            twos = _mm_add_epi16(twos, _mm_andnot_si128(blueFew, _mm_cmpeq_epi16(r, zero)));
+        }
+
+        __m128i redReach = zero;
+        __m128i blueReach = zero;
+        for (int id = 0; id < PicariaBoard::HoleCount; ++id) {
+            if (!(Rules::holes & (1u << id)))
+                continue;
+            const __m128i bit = _mm_set1_epi16(static_cast<short>(1u << id));
+            const __m128i neighbours = _mm_set1_epi16(static_cast<short>(Rules::neighbours(id)));
+            redReach = _mm_or_si128(redReach, _mm_and_si128(_mm_cmpeq_epi16(_mm_and_si128(red, bit), bit), neighbours));
+            blueReach = _mm_or_si128(blueReach, _mm_and_si128(_mm_cmpeq_epi16(_mm_and_si128(blue, bit), bit), neighbours));
+        }
+        const __m128i empty = _mm_andnot_si128(occupied, holes);
+        const __m128i dropTargets = _mm_and_si128(drop, empty);
+        const __m128i redMobility = popcount(_mm_or_si128(dropTargets, _mm_andnot_si128(drop, _mm_and_si128(redReach, empty))));
+        const __m128i blueMobility = popcount(_mm_or_si128(dropTargets, _mm_andnot_si128(drop, _mm_and_si128(blueReach, empty))));
+
+        if (results.lines) {
+            const __m128i lines = _mm_or_si128(_mm_and_si128(redLine, _mm_set1_epi16(PicariaBatch::RedLine)),
+                                               _mm_and_si128(blueLine, _mm_set1_epi16(PicariaBatch::BlueLine)));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(results.lines + i), _mm_packus_epi16(lines, lines));
+        }
+        if (results.redMobility)
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(results.redMobility + i), _mm_packus_epi16(redMobility, redMobility));
+        if (results.blueMobility)
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(results.blueMobility + i), _mm_packus_epi16(blueMobility, blueMobility));
+        if (results.scores) {
+            __m128i score = _mm_add_epi16(_mm_mullo_epi16(twos, _mm_set1_epi16(openTwoScore)),
+                                          _mm_sub_epi16(redMobility, blueMobility));
+            const __m128i negate = _mm_cmpeq_epi16(player, one);
+            score = _mm_sub_epi16(_mm_xor_si128(score, negate), negate);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(results.scores + i), score);
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+inline __m256i popcount(__m256i x) {
+    x = _mm256_sub_epi16(x, _mm256_and_si256(_mm256_srli_epi16(x, 1), _mm256_set1_epi16(0x5555)));
+    x = _mm256_add_epi16(_mm256_and_si256(x, _mm256_set1_epi16(0x3333)),
+                         _mm256_and_si256(_mm256_srli_epi16(x, 2), _mm256_set1_epi16(0x3333)));
+    x = _mm256_and_si256(_mm256_add_epi16(x, _mm256_srli_epi16(x, 4)), _mm256_set1_epi16(0x0f0f));
+    return _mm256_and_si256(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), _mm256_set1_epi16(0x1f));
+}
+
+// Sixteen bit lanes to bytes, in order.
+__attribute__((target("avx2")))
+inline void storeBytes(uint8_t* data, __m256i x) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data),
+                     _mm_packus_epi16(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1)));
+}
+
+template <PicariaBoard::Mode M>
+__attribute__((target("avx2")))
+size_t evaluateAvx2(const PicariaBatch::Positions& positions, const PicariaBatch::Results& results) {
+    typedef PicariaRules<M> Rules;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i holes = _mm256_set1_epi16(static_cast<short>(Rules::holes));
+
+    size_t i = 0;
+    for (; i + 16 <= positions.count; i += 16) {
+        const __m256i red = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(positions.red + i));
+        const __m256i blue = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(positions.blue + i));
+        const __m256i player = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(positions.player + i)));
+        const __m256i occupied = _mm256_or_si256(red, blue);
+        const __m256i drop = _mm256_cmpgt_epi16(_mm256_set1_epi16(PicariaBoard::MaxDrops), popcount(occupied));
+
+        __m256i redLine = zero;
+        __m256i blueLine = zero;
+        __m256i twos = zero;
+        for (int line = 0; line < Rules::lineCount; ++line) {
+            const __m256i mask = _mm256_set1_epi16(static_cast<short>(Rules::line(line)));
+            const __m256i r = _mm256_and_si256(red, mask);
+            const __m256i b = _mm256_and_si256(blue, mask);
+            const __m256i redFull = _mm256_cmpeq_epi16(r, mask);
+            const __m256i blueFull = _mm256_cmpeq_epi16(b, mask);
+            redLine = _mm256_or_si256(redLine, redFull);
+            blueLine = _mm256_or_si256(blueLine, blueFull);
+
+            const __m256i redFew = _mm256_or_si256(_mm256_cmpeq_epi16(_mm256_and_si256(r, _mm256_sub_epi16(r, one)), zero), redFull);
+            const __m256i blueFew = _mm256_or_si256(_mm256_cmpeq_epi16(_mm256_and_si256(b, _mm256_sub_epi16(b, one)), zero), blueFull);
+            twos = _mm256_sub_epi16(twos, _mm256_andnot_si256(redFew, _mm256_cmpeq_epi16(b, zero)));
+            twos = _mm256_add_epi16(twos, _mm256_andnot_si256(blueFew, _mm256_cmpeq_epi16(r, zero)));
+        }
+
+        __m256i redReach = zero;
+        __m256i blueReach = zero;
+        for (int id = 0; id < PicariaBoard::HoleCount; ++id) {
+            if (!(Rules::holes & (1u << id)))
+                continue;
+            const __m256i bit = _mm256_set1_epi16(static_cast<short>(1u << id));
+            const __m256i neighbours = _mm256_set1_epi16(static_cast<short>(Rules::neighbours(id)));
+            redReach = _mm256_or_si256(redReach, _mm256_and_si256(_mm256_cmpeq_epi16(_mm256_and_si256(red, bit), bit), neighbours));
+            blueReach = _mm256_or_si256(blueReach, _mm256_and_si256(_mm256_cmpeq_epi16(_mm256_and_si256(blue, bit), bit), neighbours));
+        }
+        const __m256i empty = _mm256_andnot_si256(occupied, holes);
+        const __m256i dropTargets = _mm256_and_si256(drop, empty);
+        const __m256i redMobility = popcount(_mm256_or_si256(dropTargets, _mm256_andnot_si256(drop, _mm256_and_si256(redReach, empty))));
+        const __m256i blueMobility = popcount(_mm256_or_si256(dropTargets, _mm256_andnot_si256(drop, _mm256_and_si256(blueReach, empty))));
+
+        if (results.lines)
+            storeBytes(results.lines + i, _mm256_or_si256(_mm256_and_si256(redLine, _mm256_set1_epi16(PicariaBatch::RedLine)),
+                                                          _mm256_and_si256(blueLine, _mm256_set1_epi16(PicariaBatch::BlueLine))));
+        if (results.redMobility)
+            storeBytes(results.redMobility + i, redMobility);
+        if (results.blueMobility)
+            storeBytes(results.blueMobility + i, blueMobility);
+        if (results.scores) {
+            __m256i score = _mm256_add_epi16(_mm256_mullo_epi16(twos, _mm256_set1_epi16(openTwoScore)),
+                                             _mm256_sub_epi16(redMobility, blueMobility));
+            const __m256i negate = _mm256_cmpeq_epi16(player, one);
+            score = _mm256_sub_epi16(_mm256_xor_si256(score, negate), negate);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(results.scores + i), score);
+        }
+    }
+    return i;
+}
+
+#endif
+
+template <PicariaBoard::Mode M>
+void evaluateMode(const PicariaBatch::Positions& positions, const PicariaBatch::Results& results, PicariaBatch::Kernel kernel) {
+    size_t done = 0;
+#ifdef PICARIA_X86
+    if (kernel == PicariaBatch::Avx2Kernel)
+        done = evaluateAvx2<M>(positions, results);
+    else if (kernel == PicariaBatch::Sse2Kernel)
+        done = evaluateSse2<M>(positions, results);
+#else
+    (void) kernel;
+#endif
+    evaluateScalar<M>(positions, results, done);
+}
+
+}
+
+bool PicariaBatch::isSupported(Kernel kernel) {
+#ifdef PICARIA_X86
+    // Asked once: the answer does not change while the process runs.
+    static const bool sse2 = __builtin_cpu_supports("sse2");
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return kernel == ScalarKernel || (kernel == Sse2Kernel && sse2) || (kernel == Avx2Kernel && avx2);
+#else
+    return kernel == ScalarKernel;
+#endif
+}
+
+PicariaBatch::Kernel PicariaBatch::bestKernel() {
+    if (PicariaBatch::isSupported(Avx2Kernel))
+        return Avx2Kernel;
+    if (PicariaBatch::isSupported(Sse2Kernel))
+        return Sse2Kernel;
+    return ScalarKernel;
+}
+
+const char* PicariaBatch::name(Kernel kernel) {
+    switch (kernel) {
+    case Sse2Kernel:
+        return "sse2";
+    case Avx2Kernel:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+void PicariaBatch::evaluate(PicariaBoard::Mode mode, const Positions& positions, const Results& results, Kernel kernel) {
+    if (!PicariaBatch::isSupported(kernel))
+        kernel = ScalarKernel;
+
+    if (mode == PicariaBoard::NineHoles)
+        evaluateMode<PicariaBoard::NineHoles>(positions, results, kernel);
+    else
+        evaluateMode<PicariaBoard::ThirteenHoles>(positions, results, kernel);
+}
@@ -0,0 +1,61 @@
+#ifndef PICARIABATCH_H
+#define PICARIABATCH_H
+
+#include "PicariaBoard.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Scores many positions of one mode at once. Positions are given as
+// arrays, one per field (structure of arrays): the red and blue pieces and
+// the side to move, as in PicariaBoard; the phase follows from the number
+// of pieces. For each position the batch finds:
+//
+//   lines      RedLine and BlueLine, for the players owning three in a row
+//   mobility   for each player, the holes the player could play to
+//   score      PicariaSearch's evaluation, from the side to move
+//
+// Kernels run eight (SSE2) or sixteen (AVX2) positions per instruction,
+// and the scalar kernel takes the rest. The kernel is picked at run time
+// by what the processor supports; every kernel gives the same results.
+class PicariaBatch {
+public:
+    enum Kernel {
+        ScalarKernel,
+        Sse2Kernel,
+        Avx2Kernel
+    };
+
+    enum Line : uint8_t {
+        RedLine = 1,
+        BlueLine = 2
+    };
+
+    struct Positions {
+        size_t count;
+        const uint16_t* red;
+        const uint16_t* blue;
+        const uint8_t* player;
+    };
+
+    // count entries each; null arrays are not written.
+    struct Results {
+        uint8_t* lines;
+        uint8_t* redMobility;
+        uint8_t* blueMobility;
+        int16_t* scores;
+    };
+
+    static bool isSupported(Kernel kernel);
+    static Kernel bestKernel();
+    static const char* name(Kernel kernel);
+
+    static void evaluate(PicariaBoard::Mode mode, const Positions& positions, const Results& results) {
+        PicariaBatch::evaluate(mode, positions, results, PicariaBatch::bestKernel());
+    }
+    // Falls back to the scalar kernel for one the processor lacks.
+    static void evaluate(PicariaBoard::Mode mode, const Positions& positions, const Results& results, Kernel kernel);
+
+};
+
+#endif // PICARIABATCH_H
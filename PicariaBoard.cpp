@@ -0,0 +1,129 @@
+#include "PicariaBoard.h"
+
+#include "PicariaRules.h"
+
+#include <cassert>
+
+PicariaBoard::PicariaBoard(Mode mode) {
+    this->reset(mode);
+}
+
+PicariaBoard::PicariaBoard(Mode mode, uint16_t red, uint16_t blue, Player player) {
+    int count = __builtin_popcount(red | blue);
+
+    m_pieces[PicariaBoard::RedPlayer] = red;
+    m_pieces[PicariaBoard::BluePlayer] = blue;
+    m_mode = mode;
+    m_player = player;
+    m_dropCount = count < MaxDrops ? count : MaxDrops;
+    m_phase = m_dropCount == MaxDrops ? PicariaBoard::MovePhase : PicariaBoard::DropPhase;
+}
+
+uint16_t PicariaBoard::holes(Mode mode) {
+    return PicariaGeometry::holes[mode];
+}
+
+PicariaBoard::Cell PicariaBoard::cellAt(int id) const {
+    if (this->hasPiece(PicariaBoard::RedPlayer, id))
+        return PicariaBoard::RedCell;
+    else if (this->hasPiece(PicariaBoard::BluePlayer, id))
+        return PicariaBoard::BlueCell;
+    else
+        return PicariaBoard::EmptyCell;
+}
+
+uint16_t PicariaBoard::neighbours(Mode mode, int id) {
+    return PicariaGeometry::adjacency[mode][id];
+}
+
+bool PicariaBoard::hasLine(Player player) const {
+    uint16_t pieces = m_pieces[player];
+    return picariaDispatch(this->mode(), [pieces](auto rules) {
+        return rules.hasLine(pieces);
+    });
+}
+
+bool PicariaBoard::hasLineThrough(Player player, int id) const {
+    uint16_t pieces = m_pieces[player];
+    return picariaDispatch(this->mode(), [pieces, id](auto rules) {
+        return rules.hasLineThrough(pieces, id);
+    });
+}
+
+PicariaMoveList PicariaBoard::moves() const {
+    PicariaMoveList list;
+    picariaDispatch(this->mode(), [this, &list](auto rules) {
+        rules.generate(*this, list);
+    });
+    return list;
+}
+
+bool PicariaBoard::hasMoves() const {
+    return picariaDispatch(this->mode(), [this](auto rules) {
+        return rules.targets(this->pieces(this->player()), this->occupied(), this->phase()) != 0;
+    });
+}
+
+bool PicariaBoard::canDrop(int id) const {
+    return m_phase == PicariaBoard::DropPhase && this->isEmpty(id);
+}
+
+void PicariaBoard::drop(int id) {
+    assert(this->canDrop(id));
+
+    m_pieces[m_player] |= 1u << id;
+    m_dropCount++;
+    if (m_dropCount == MaxDrops)
+        m_phase = PicariaBoard::MovePhase;
+
+    this->switchPlayer();
+}
+
+bool PicariaBoard::canSlide(int from, int to) const {
+    return m_phase == PicariaBoard::MovePhase && this->hasPiece(this->player(), from) &&
+            to >= 0 && to < HoleCount && (this->destinations(from) & (1u << to));
+}
+
+void PicariaBoard::slide(int from, int to) {
+    assert(this->canSlide(from, to));
+
+    m_pieces[m_player] = (m_pieces[m_player] & ~(1u << from)) | (1u << to);
+
+    this->switchPlayer();
+}
+
+void PicariaBoard::undo(PicariaMove move) {
+    this->switchPlayer();
+    assert(this->hasPiece(this->player(), move.to));
+
+    if (move.isDrop()) {
+        assert(m_dropCount > 0);
+        m_pieces[m_player] &= ~(1u << move.to);
+        m_dropCount--;
+        m_phase = PicariaBoard::DropPhase;
+    }
+    else {
+        assert(this->isEmpty(move.from));
+        m_pieces[m_player] = (m_pieces[m_player] & ~(1u << move.to)) | (1u << move.from);
+    }
+}
+
+void PicariaBoard::reset(Mode mode) {
+    m_pieces[PicariaBoard::RedPlayer] = 0;
+    m_pieces[PicariaBoard::BluePlayer] = 0;
+    m_mode = mode;
+    m_player = PicariaBoard::RedPlayer;
+    m_phase = PicariaBoard::DropPhase;
+    m_dropCount = 0;
+}
+
+bool PicariaBoard::operator==(const PicariaBoard& other) const {
+    return m_pieces[PicariaBoard::RedPlayer] == other.m_pieces[PicariaBoard::RedPlayer] &&
+            m_pieces[PicariaBoard::BluePlayer] == other.m_pieces[PicariaBoard::BluePlayer] &&
+            m_mode == other.m_mode && m_player == other.m_player &&
+            m_phase == other.m_phase && m_dropCount == other.m_dropCount;
+}
+
+void PicariaBoard::switchPlayer() {
+    m_player = PicariaBoard::opponent(this->player());
+}
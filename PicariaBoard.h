@@ -0,0 +1,100 @@
+#ifndef PICARIABOARD_H
+#define PICARIABOARD_H
+
+#include "PicariaMove.h"
+
+#include <cstdint>
+
+// Qt-free game state. Holes are numbered 0..12 row by row, exactly like
+// hole01..hole13 in the user interface; bit n of a mask is hole n.
+class PicariaBoard {
+public:
+    enum Mode {
+        NineHoles,
+        ThirteenHoles
+    };
+
+    enum Player {
+        RedPlayer,
+        BluePlayer
+    };
+
+    enum Phase {
+        DropPhase,
+        MovePhase
+    };
+
+    enum Cell {
+        EmptyCell,
+        RedCell,
+        BlueCell
+    };
+
+    static const int HoleCount = 13;
+    static const int MaxDrops = 6;
+
+    explicit PicariaBoard(Mode mode = NineHoles);
+    // A position given by its pieces; the phase and drop count follow
+    // from the number of pieces on the board.
+    PicariaBoard(Mode mode, uint16_t red, uint16_t blue, Player player);
+
+    Mode mode() const { return static_cast<Mode>(m_mode); }
+    Player player() const { return static_cast<Player>(m_player); }
+    Phase phase() const { return static_cast<Phase>(m_phase); }
+    int dropCount() const { return m_dropCount; }
+
+    uint16_t pieces(Player player) const { return m_pieces[player]; }
+    uint16_t occupied() const { return m_pieces[RedPlayer] | m_pieces[BluePlayer]; }
+    uint16_t holes() const { return PicariaBoard::holes(this->mode()); }
+
+    Cell cellAt(int id) const;
+    bool isEmpty(int id) const { return this->isHole(id) && !(this->occupied() & (1u << id)); }
+    bool isHole(int id) const { return id >= 0 && id < HoleCount && (this->holes() & (1u << id)); }
+    bool hasPiece(Player player, int id) const { return id >= 0 && id < HoleCount && (m_pieces[player] & (1u << id)); }
+
+    // Empty holes the piece on hole id could slide to.
+    uint16_t destinations(int id) const { return PicariaBoard::neighbours(this->mode(), id) & ~this->occupied(); }
+
+    // Three pieces of the player in a row, anywhere or only through hole id.
+    // After a move only the lines through its destination can be new.
+    bool hasLine(Player player) const;
+    bool hasLineThrough(Player player, int id) const;
+
+    bool canDrop(int id) const;
+    void drop(int id);
+
+    bool canSlide(int from, int to) const;
+    void slide(int from, int to);
+
+    bool canPlay(PicariaMove move) const { return move.isDrop() ? this->canDrop(move.to) : this->canSlide(move.from, move.to); }
+    void play(PicariaMove move) { if (move.isDrop()) this->drop(move.to); else this->slide(move.from, move.to); }
+
+    // Takes back move, which must be the last move played on this board.
+    // With play() this makes a board usable as a make/unmake stack.
+    void undo(PicariaMove move);
+
+    // Legal moves of the side to move. Without any, the side to move loses.
+    PicariaMoveList moves() const;
+    bool hasMoves() const;
+
+    void reset(Mode mode);
+
+    static uint16_t holes(Mode mode);
+    static uint16_t neighbours(Mode mode, int id);
+    static Player opponent(Player player) { return player == RedPlayer ? BluePlayer : RedPlayer; }
+
+    bool operator==(const PicariaBoard& other) const;
+    bool operator!=(const PicariaBoard& other) const { return !(*this == other); }
+
+private:
+    uint16_t m_pieces[2];
+    uint8_t m_mode;
+    uint8_t m_player;
+    uint8_t m_phase;
+    uint8_t m_dropCount;
+
+    void switchPlayer();
+
+};
+
+#endif // PICARIABOARD_H
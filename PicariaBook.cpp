@@ -0,0 +1,72 @@
+#include "PicariaBook.h"
+#include "PicariaDataFile.h"
+#include "PicariaSymmetry.h"
+#include "PicariaTablebase.h"
+
+#include <algorithm>
+#include <utility>
+
+PicariaBook::PicariaBook()
+    : m_entries{nullptr, nullptr},
+      m_sizes{0, 0} {
+}
+
+PicariaBook::~PicariaBook() {
+}
+
+PicariaMove PicariaBook::move(const PicariaBoard& board, int* score) const {
+    const Entry* begin = m_entries[board.mode()];
+    const Entry* end = begin + m_sizes[board.mode()];
+    if (begin == end)
+        return PicariaMove();
+
+    int symmetry = PicariaSymmetry::canonical(board);
+    uint32_t index = static_cast<uint32_t>(PicariaTablebase::index(board));
+    const Entry* entry = std::lower_bound(begin, end, index, [](const Entry& entry, uint32_t index) {
+        return entry.index < index;
+    });
+    if (entry == end || entry->index != index)
+        return PicariaMove();
+
+    PicariaMove canonical = entry->from < 0 ? PicariaMove::drop(entry->to) : PicariaMove::slide(entry->from, entry->to);
+    PicariaMove move = PicariaSymmetry::move(PicariaSymmetry::inverse(symmetry), canonical);
+    if (!board.canPlay(move))
+        return PicariaMove();
+
+    if (score != nullptr)
+        *score = entry->score;
+    return move;
+}
+
+void PicariaBook::setEntries(PicariaBoard::Mode mode, std::vector<Entry> entries) {
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.index < b.index;
+    });
+    m_owned[mode] = std::move(entries);
+    m_entries[mode] = m_owned[mode].empty() ? nullptr : m_owned[mode].data();
+    m_sizes[mode] = m_owned[mode].size();
+}
+
+bool PicariaBook::load(const std::string& path) {
+    return this->load(PicariaDataFile::open(path));
+}
+
+bool PicariaBook::load(std::shared_ptr<const PicariaDataFile> file) {
+    if (!file)
+        return false;
+
+    const void* sections[2];
+    size_t counts[2];
+    for (int mode = 0; mode < 2; ++mode)
+        sections[mode] = file->section(PicariaDataFile::BookSection, static_cast<PicariaBoard::Mode>(mode), counts[mode]);
+    if (sections[0] == nullptr && sections[1] == nullptr)
+        return false;
+
+    for (int mode = 0; mode < 2; ++mode) {
+        m_owned[mode].clear();
+        m_entries[mode] = static_cast<const Entry*>(sections[mode]);
+        m_sizes[mode] = counts[mode];
+    }
+    m_file = std::move(file);
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef PICARIABOOK_H
+#define PICARIABOOK_H
+
+#include "PicariaBoard.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class PicariaDataFile;
+
+// Opening book: a chosen move for positions of the drop phase. Entries
+// are keyed by the PicariaTablebase index of the position, so the eight
+// symmetric images of a position share one entry, and its move is stored
+// in the frame of the canonical representative. Like the tablebase, the
+// entries are owned or read in place from a mapped PicariaDataFile.
+class PicariaBook {
+public:
+    // The on-disk record, sorted by index.
+    struct Entry {
+        uint32_t index;
+        int8_t from;
+        int8_t to;
+        int16_t score;
+    };
+
+    PicariaBook();
+    ~PicariaBook();
+
+    PicariaBook(const PicariaBook&) = delete;
+    PicariaBook& operator=(const PicariaBook&) = delete;
+
+    size_t size(PicariaBoard::Mode mode) const { return m_sizes[mode]; }
+    const Entry* data(PicariaBoard::Mode mode) const { return m_entries[mode]; }
+
+    // The book move and its score for the side to move, or a null move.
+    PicariaMove move(const PicariaBoard& board, int* score = nullptr) const;
+
+    // Entries in any order; they are sorted here.
+    void setEntries(PicariaBoard::Mode mode, std::vector<Entry> entries);
+
+    // Uses the book sections of a data file, for the modes it has.
+    bool load(const std::string& path);
+    bool load(std::shared_ptr<const PicariaDataFile> file);
+
+private:
+    std::vector<Entry> m_owned[2];
+    const Entry* m_entries[2];
+    size_t m_sizes[2];
+    std::shared_ptr<const PicariaDataFile> m_file;
+
+};
+
+#endif // PICARIABOOK_H
@@ -0,0 +1,49 @@
+# Qt-free game core, shared by the application and the command line tools.
+
+CONFIG += thread
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/PicariaBatch.cpp \
+    $$PWD/PicariaBoard.cpp \
+    $$PWD/PicariaBook.cpp \
+    $$PWD/PicariaDataFile.cpp \
+    $$PWD/PicariaGame.cpp \
+    $$PWD/PicariaIndex.cpp \
+    $$PWD/PicariaJournal.cpp \
+    $$PWD/PicariaMcts.cpp \
+    $$PWD/PicariaOracle.cpp \
+    $$PWD/PicariaPool.cpp \
+    $$PWD/PicariaProtocol.cpp \
+    $$PWD/PicariaRecord.cpp \
+    $$PWD/PicariaSearch.cpp \
+    $$PWD/PicariaSolver.cpp \
+    $$PWD/PicariaSymmetry.cpp \
+    $$PWD/PicariaTablebase.cpp \
+    $$PWD/PicariaTranspositionTable.cpp \
+    $$PWD/PicariaZobrist.cpp
+
+HEADERS += \
+    $$PWD/PicariaBatch.h \
+    $$PWD/PicariaBoard.h \
+    $$PWD/PicariaBook.h \
+    $$PWD/PicariaDataFile.h \
+    $$PWD/PicariaEngine.h \
+    $$PWD/PicariaGame.h \
+    $$PWD/PicariaIndex.h \
+    $$PWD/PicariaJournal.h \
+    $$PWD/PicariaMcts.h \
+    $$PWD/PicariaMove.h \
+    $$PWD/PicariaOracle.h \
+    $$PWD/PicariaPool.h \
+    $$PWD/PicariaProtocol.h \
+    $$PWD/PicariaRecord.h \
+    $$PWD/PicariaRules.h \
+    $$PWD/PicariaSearch.h \
+    $$PWD/PicariaSolver.h \
+    $$PWD/PicariaSymmetry.h \
+    $$PWD/PicariaTablebase.h \
+    $$PWD/PicariaTranspositionTable.h \
+    $$PWD/PicariaZobrist.h
@@ -0,0 +1,214 @@
+#include "PicariaDataFile.h"
+#include "PicariaBook.h"
+#include "PicariaTablebase.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char magic[4] = { 'P', 'C', 'D', 'B' };
+const uint32_t byteOrder = 0x01020304u;
+
+struct Crc32 {
+    uint32_t table[256];
+
+    Crc32() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = crc & 1 ? 0xedb88320u ^ (crc >> 1) : crc >> 1;
+            table[i] = crc;
+        }
+    }
+};
+
+size_t align(size_t offset) {
+    return (offset + 7) & ~static_cast<size_t>(7);
+}
+
+}
+
+PicariaDataFile::PicariaDataFile()
+    : m_data(nullptr),
+      m_size(0) {
+}
+
+PicariaDataFile::~PicariaDataFile() {
+#ifndef _WIN32
+    if (m_data != nullptr && !m_copy)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+}
+
+std::shared_ptr<const PicariaDataFile> PicariaDataFile::open(const std::string& path) {
+    std::shared_ptr<PicariaDataFile> file(new PicariaDataFile());
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED) {
+            file->m_data = static_cast<const uint8_t*>(data);
+            file->m_size = static_cast<size_t>(info.st_size);
+        }
+    }
+    ::close(fd);
+#endif
+
+    // Without mmap, read the file; queries work the same on the copy.
+    if (file->m_data == nullptr) {
+        std::ifstream stream(path, std::ios::binary | std::ios::ate);
+        if (!stream)
+            return nullptr;
+        size_t size = static_cast<size_t>(stream.tellg());
+        file->m_copy.reset(new uint8_t[size > 0 ? size : 1]);
+        stream.seekg(0);
+        if (!stream.read(reinterpret_cast<char*>(file->m_copy.get()), static_cast<std::streamsize>(size)))
+            return nullptr;
+        file->m_data = file->m_copy.get();
+        file->m_size = size;
+    }
+
+    if (!file->isValid())
+        return nullptr;
+    return file;
+}
+
+bool PicariaDataFile::isValid() const {
+    if (m_size < sizeof(Header))
+        return false;
+
+    const Header* header = reinterpret_cast<const Header*>(m_data);
+    if (!std::equal(magic, magic + 4, header->magic) || header->version != Version ||
+            header->byteOrder != byteOrder)
+        return false;
+
+    size_t tableSize = header->sectionCount * sizeof(Section);
+    if (header->sectionCount > 64 || m_size < sizeof(Header) + tableSize ||
+            PicariaDataFile::checksum(this->sections(), tableSize) != header->checksum)
+        return false;
+
+    for (uint32_t i = 0; i < header->sectionCount; ++i) {
+        const Section& section = this->sections()[i];
+        size_t record = section.kind == TablebaseSection ? 1 :
+                        section.kind == BookSection ? sizeof(PicariaBook::Entry) : 0;
+        if (section.offset % 8 != 0 || section.offset > m_size || section.size > m_size - section.offset ||
+                (record != 0 && section.size != section.count * record) ||
+                PicariaDataFile::checksum(m_data + section.offset, section.size) != section.checksum)
+            return false;
+    }
+    return true;
+}
+
+const void* PicariaDataFile::section(Kind kind, PicariaBoard::Mode mode, size_t& count) const {
+    const Header* header = reinterpret_cast<const Header*>(m_data);
+    for (uint32_t i = 0; i < header->sectionCount; ++i) {
+        const Section& section = this->sections()[i];
+        if (section.kind == static_cast<uint32_t>(kind) && section.mode == static_cast<uint32_t>(mode)) {
+            count = section.count;
+            return m_data + section.offset;
+        }
+    }
+    count = 0;
+    return nullptr;
+}
+
+bool PicariaDataFile::save(const std::string& path, const PicariaTablebase* tablebase, const PicariaBook* book) {
+    struct Block {
+        Section section;
+        const void* data;
+    };
+
+    std::vector<Block> blocks;
+    for (int mode = 0; mode < 2; ++mode) {
+        PicariaBoard::Mode m = static_cast<PicariaBoard::Mode>(mode);
+        if (tablebase != nullptr && !tablebase->isEmpty(m)) {
+            Section section = { TablebaseSection, static_cast<uint32_t>(mode), static_cast<uint32_t>(tablebase->size(m)), 0, 0, tablebase->size(m) };
+            blocks.push_back({ section, tablebase->data(m) });
+        }
+        if (book != nullptr && book->size(m) > 0) {
+            Section section = { BookSection, static_cast<uint32_t>(mode), static_cast<uint32_t>(book->size(m)), 0, 0,
+                                book->size(m) * sizeof(PicariaBook::Entry) };
+            blocks.push_back({ section, book->data(m) });
+        }
+    }
+
+    std::vector<Section> table;
+    size_t offset = align(sizeof(Header) + blocks.size() * sizeof(Section));
+    for (Block& block : blocks) {
+        block.section.offset = offset;
+        block.section.checksum = PicariaDataFile::checksum(block.data, block.section.size);
+        table.push_back(block.section);
+        offset = align(offset + block.section.size);
+    }
+
+    Header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = Version;
+    header.byteOrder = byteOrder;
+    header.sectionCount = static_cast<uint32_t>(table.size());
+    header.checksum = PicariaDataFile::checksum(table.data(), table.size() * sizeof(Section));
+    header.reserved = 0;
+
+    std::vector<uint8_t> bytes(offset, 0);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    if (!table.empty())
+        std::memcpy(bytes.data() + sizeof(header), table.data(), table.size() * sizeof(Section));
+    for (const Block& block : blocks)
+        if (block.section.size > 0)
+            std::memcpy(bytes.data() + block.section.offset, block.data, block.section.size);
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file.flush())
+            return false;
+    }
+#ifdef _WIN32
+    // rename() fails on Windows when the target exists.
+    return MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+#endif
+}
+
+void PicariaDataFile::load(std::shared_ptr<const PicariaDataFile> file,
+                           std::shared_ptr<const PicariaTablebase>& tablebase,
+                           std::shared_ptr<const PicariaBook>& book) {
+    if (!file)
+        return;
+
+    auto loadedTablebase = std::make_shared<PicariaTablebase>();
+    if (loadedTablebase->load(file))
+        tablebase = loadedTablebase;
+    auto loadedBook = std::make_shared<PicariaBook>();
+    if (loadedBook->load(file))
+        book = loadedBook;
+}
+
+uint32_t PicariaDataFile::checksum(const void* data, size_t size) {
+    static const Crc32 crc32;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint32_t crc = 0xffffffffu;
+    for (size_t i = 0; i < size; ++i)
+        crc = crc32.table[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
@@ -0,0 +1,91 @@
+#ifndef PICARIADATAFILE_H
+#define PICARIADATAFILE_H
+
+#include "PicariaBoard.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class PicariaBook;
+class PicariaTablebase;
+
+// Solved positions and book moves on disk. The file is memory mapped and
+// queried in place, so opening it costs no parsing and every process on
+// a host shares the same pages.
+//
+// Layout, in the byte order of the host that wrote the file, since the
+// data is used in place:
+//   header   magic "PCDB", version, byte order mark, section count,
+//            checksum of the section table
+//   sections kind, mode, record count, checksum, offset and size of the
+//            data of every section
+//   data     one block per section, aligned to 8 bytes
+// Checksums are CRC-32. A file with an unknown version, a byte order mark
+// that reads swapped or a bad checksum is rejected as a whole.
+class PicariaDataFile {
+public:
+    static const uint32_t Version = 3;
+
+    enum Kind {
+        TablebaseSection = 1,
+        BookSection = 2
+    };
+
+    ~PicariaDataFile();
+
+    PicariaDataFile(const PicariaDataFile&) = delete;
+    PicariaDataFile& operator=(const PicariaDataFile&) = delete;
+
+    // The mapped file, or null when it is missing or invalid.
+    static std::shared_ptr<const PicariaDataFile> open(const std::string& path);
+
+    // Writes the non-empty modes of both; either may be null. The file is
+    // replaced atomically, so processes that mapped the old one keep it.
+    static bool save(const std::string& path, const PicariaTablebase* tablebase, const PicariaBook* book);
+
+    // The tablebase and the book of a file, each left null when the file
+    // has none of it; file may be null.
+    static void load(std::shared_ptr<const PicariaDataFile> file,
+                     std::shared_ptr<const PicariaTablebase>& tablebase,
+                     std::shared_ptr<const PicariaBook>& book);
+
+    // Data and record count of a section, or null when the file has none.
+    const void* section(Kind kind, PicariaBoard::Mode mode, size_t& count) const;
+
+    static uint32_t checksum(const void* data, size_t size);
+
+private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t sectionCount;
+        uint32_t checksum;
+        // Keeps the section table aligned to 8 bytes.
+        uint32_t reserved;
+    };
+
+    struct Section {
+        uint32_t kind;
+        uint32_t mode;
+        uint32_t count;
+        uint32_t checksum;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    const uint8_t* m_data;
+    size_t m_size;
+    // Set when the file could not be mapped and was read instead.
+    std::unique_ptr<uint8_t[]> m_copy;
+
+    PicariaDataFile();
+
+    const Section* sections() const { return reinterpret_cast<const Section*>(m_data + sizeof(Header)); }
+    bool isValid() const;
+
+};
+
+#endif // PICARIADATAFILE_H
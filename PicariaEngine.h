@@ -0,0 +1,32 @@
+#ifndef PICARIAENGINE_H
+#define PICARIAENGINE_H
+
+#include "PicariaBoard.h"
+
+#include <atomic>
+
+// A computer player. Engines are not thread safe: one think() at a time,
+// but stop() and resume() may be called from any thread.
+class PicariaEngine {
+public:
+    virtual ~PicariaEngine() {}
+
+    // Best move found within the time limit; a null move if there is none.
+    virtual PicariaMove think(const PicariaBoard& board, int milliseconds) = 0;
+
+    // Forgets everything learned from earlier games.
+    virtual void clear() {}
+
+    // Makes think() return its best move so far as soon as possible. The
+    // request holds until resume(), so it also stops a think() that has
+    // not started yet. Engines wrapping another engine pass both on.
+    virtual void stop() { m_stopped.store(true, std::memory_order_relaxed); }
+    virtual void resume() { m_stopped.store(false, std::memory_order_relaxed); }
+    bool isStopped() const { return m_stopped.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> m_stopped{false};
+
+};
+
+#endif // PICARIAENGINE_H
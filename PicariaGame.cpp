@@ -0,0 +1,48 @@
+#include "PicariaGame.h"
+
+PicariaGame::PicariaGame(PicariaBoard::Mode mode)
+    : m_board(mode),
+      m_ply(0) {
+}
+
+bool PicariaGame::isOver() const {
+    if (m_ply == 0)
+        return false;
+    const PicariaMove& last = m_moves[m_ply - 1];
+    return m_board.hasLineThrough(this->winner(), last.to) || !m_board.hasMoves();
+}
+
+bool PicariaGame::play(PicariaMove move) {
+    if (move.isNull() || this->isOver() || !m_board.canPlay(move))
+        return false;
+
+    m_board.play(move);
+    m_moves.resize(m_ply);
+    m_moves.push_back(move);
+    ++m_ply;
+    return true;
+}
+
+PicariaMove PicariaGame::undo() {
+    if (!this->canUndo())
+        return PicariaMove();
+
+    PicariaMove move = m_moves[--m_ply];
+    m_board.undo(move);
+    return move;
+}
+
+PicariaMove PicariaGame::redo() {
+    if (!this->canRedo())
+        return PicariaMove();
+
+    PicariaMove move = m_moves[m_ply++];
+    m_board.play(move);
+    return move;
+}
+
+void PicariaGame::reset(PicariaBoard::Mode mode) {
+    m_board.reset(mode);
+    m_moves.clear();
+    m_ply = 0;
+}
@@ -0,0 +1,47 @@
+#ifndef PICARIAGAME_H
+#define PICARIAGAME_H
+
+#include "PicariaBoard.h"
+
+#include <cstddef>
+#include <vector>
+
+// A game in progress: the board and every move played on it, kept as a
+// make/unmake stack. Undone moves stay on the stack until a different
+// move is played, so they can be redone.
+class PicariaGame {
+public:
+    explicit PicariaGame(PicariaBoard::Mode mode = PicariaBoard::NineHoles);
+
+    const PicariaBoard& board() const { return m_board; }
+    PicariaBoard::Mode mode() const { return m_board.mode(); }
+
+    // Moves from the start position; the first ply() of them are played.
+    const std::vector<PicariaMove>& moves() const { return m_moves; }
+    size_t ply() const { return m_ply; }
+
+    // The player who moved last made a line, or the side to move is
+    // blocked. Either way the side to move lost.
+    bool isOver() const;
+    PicariaBoard::Player winner() const { return PicariaBoard::opponent(m_board.player()); }
+
+    // Plays a legal move; returns false for an illegal one or after the
+    // end of the game.
+    bool play(PicariaMove move);
+
+    bool canUndo() const { return m_ply > 0; }
+    bool canRedo() const { return m_ply < m_moves.size(); }
+    // The move taken back or played again, or a null move.
+    PicariaMove undo();
+    PicariaMove redo();
+
+    void reset(PicariaBoard::Mode mode);
+
+private:
+    PicariaBoard m_board;
+    std::vector<PicariaMove> m_moves;
+    size_t m_ply;
+
+};
+
+#endif // PICARIAGAME_H
@@ -0,0 +1,107 @@
+#include "PicariaIndex.h"
+
+#include <cassert>
+
+PicariaIndex::Tables::Tables() {
+    for (int n = 0; n <= PicariaBoard::HoleCount; ++n)
+        for (int k = 0; k < 4; ++k)
+            binomial[n][k] = k == 0 ? 1 : n == 0 ? 0 : binomial[n - 1][k - 1] + binomial[n - 1][k];
+
+    for (int group = 0; group < GroupCount; ++group) {
+        int pieces = group < PicariaBoard::MaxDrops ? group : PicariaBoard::MaxDrops;
+        red[group] = static_cast<uint8_t>((pieces + 1) / 2);
+        blue[group] = static_cast<uint8_t>(pieces / 2);
+        player[group] = static_cast<uint8_t>(group < PicariaBoard::MaxDrops ? group % 2 : group - PicariaBoard::MaxDrops);
+    }
+
+    for (int mode = 0; mode < 2; ++mode) {
+        uint16_t holes = PicariaBoard::holes(static_cast<PicariaBoard::Mode>(mode));
+        int n = 0;
+        for (int id = 0; id < PicariaBoard::HoleCount; ++id) {
+            position[mode][id] = -1;
+            if (holes & (1u << id)) {
+                position[mode][id] = static_cast<int8_t>(n);
+                hole[mode][n++] = static_cast<int8_t>(id);
+            }
+        }
+        holeCount[mode] = n;
+
+        offset[mode][0] = 0;
+        for (int group = 0; group < GroupCount; ++group)
+            offset[mode][group + 1] = offset[mode][group] +
+                    binomial[n][red[group]] * binomial[n - red[group]][blue[group]];
+        size[mode] = offset[mode][GroupCount];
+    }
+}
+
+const PicariaIndex::Tables& PicariaIndex::tables() {
+    static const Tables instance;
+    return instance;
+}
+
+size_t PicariaIndex::rank(PicariaBoard::Mode mode, uint16_t red, uint16_t blue, PicariaBoard::Player player) {
+    const Tables& t = PicariaIndex::tables();
+    const uint16_t holes = PicariaBoard::holes(mode);
+    int redCount = __builtin_popcount(red);
+    int blueCount = __builtin_popcount(blue);
+    int pieces = redCount + blueCount;
+    int group = pieces < PicariaBoard::MaxDrops ? pieces : PicariaBoard::MaxDrops + player;
+    assert(redCount == t.red[group] && blueCount == t.blue[group] && player == t.player[group]);
+
+    uint32_t redRank = 0;
+    int i = 1;
+    for (uint16_t set = red; set != 0; set &= set - 1)
+        redRank += t.binomial[t.position[mode][__builtin_ctz(set)]][i++];
+
+    uint32_t blueRank = 0;
+    uint16_t free = holes & ~red;
+    i = 1;
+    for (uint16_t set = blue; set != 0; set &= set - 1)
+        blueRank += t.binomial[__builtin_popcount(free & ((set & -set) - 1))][i++];
+
+    return t.offset[mode][group] + redRank * t.binomial[t.holeCount[mode] - redCount][blueCount] + blueRank;
+}
+
+PicariaBoard PicariaIndex::board(PicariaBoard::Mode mode, size_t index) {
+    const Tables& t = PicariaIndex::tables();
+    assert(index < t.size[mode]);
+
+    int group = 0;
+    while (index >= t.offset[mode][group + 1])
+        ++group;
+
+    const int n = t.holeCount[mode];
+    const int redCount = t.red[group];
+    const int blueCount = t.blue[group];
+    uint32_t rest = static_cast<uint32_t>(index - t.offset[mode][group]);
+    uint32_t redRank = rest / t.binomial[n - redCount][blueCount];
+    uint32_t blueRank = rest % t.binomial[n - redCount][blueCount];
+
+    // Colex unranking: the k-th piece sits on the highest position p with
+    // binomial(p, k) still within the rank.
+    uint16_t red = 0;
+    int p = n;
+    for (int k = redCount; k > 0; --k) {
+        while (t.binomial[--p][k] > redRank)
+            ;
+        redRank -= t.binomial[p][k];
+        red |= 1u << t.hole[mode][p];
+    }
+
+    int free[PicariaBoard::HoleCount];
+    int freeCount = 0;
+    for (int q = 0; q < n; ++q)
+        if (!(red & (1u << t.hole[mode][q])))
+            free[freeCount++] = t.hole[mode][q];
+
+    uint16_t blue = 0;
+    p = freeCount;
+    for (int k = blueCount; k > 0; --k) {
+        while (t.binomial[--p][k] > blueRank)
+            ;
+        blueRank -= t.binomial[p][k];
+        blue |= 1u << free[p];
+    }
+
+    return PicariaBoard(mode, red, blue, static_cast<PicariaBoard::Player>(t.player[group]));
+}
@@ -0,0 +1,54 @@
+#ifndef PICARIAINDEX_H
+#define PICARIAINDEX_H
+
+#include "PicariaBoard.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Dense, collision-free numbering of the positions of one board mode, so
+// that any per-position table is a flat array. Every position that can
+// follow from the rules' piece counts gets a number below size(mode):
+// 5710 on the nine holes board and 86828 on the thirteen holes board.
+//
+// Positions are grouped by piece counts and side to move: while dropping
+// these follow from the number of pieces, afterwards both sides have
+// three. Inside a group the red pieces are ranked among the holes, then
+// the blue pieces among the holes red left free, both in combinatorial
+// (colex) order. Ranking and unranking loop over at most three pieces.
+class PicariaIndex {
+public:
+    static size_t size(PicariaBoard::Mode mode) { return PicariaIndex::tables().size[mode]; }
+
+    // The pieces must have counts the rules allow for the side to move.
+    static size_t rank(const PicariaBoard& board) {
+        return PicariaIndex::rank(board.mode(), board.pieces(PicariaBoard::RedPlayer),
+                                  board.pieces(PicariaBoard::BluePlayer), board.player());
+    }
+    static size_t rank(PicariaBoard::Mode mode, uint16_t red, uint16_t blue, PicariaBoard::Player player);
+    static PicariaBoard board(PicariaBoard::Mode mode, size_t index);
+
+private:
+    // Red and blue piece counts and side to move of each group: one per
+    // drop, then the move phase with red and with blue to move.
+    static const int GroupCount = PicariaBoard::MaxDrops + 2;
+
+    struct Tables {
+        int holeCount[2];
+        int8_t position[2][PicariaBoard::HoleCount];
+        int8_t hole[2][PicariaBoard::HoleCount];
+        uint32_t binomial[PicariaBoard::HoleCount + 1][4];
+        uint8_t red[GroupCount];
+        uint8_t blue[GroupCount];
+        uint8_t player[GroupCount];
+        uint32_t offset[2][GroupCount + 1];
+        size_t size[2];
+
+        Tables();
+    };
+
+    static const Tables& tables();
+
+};
+
+#endif // PICARIAINDEX_H
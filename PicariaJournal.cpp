@@ -0,0 +1,300 @@
+#include "PicariaJournal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char magic[4] = { 'P', 'C', 'J', 'L' };
+const size_t headerSize = 8;
+const size_t entrySize = 4;
+
+#ifdef _WIN32
+int openFile(const char* path) { return ::_open(path, _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE); }
+int closeFile(int fd) { return ::_close(fd); }
+long readFile(int fd, void* data, size_t size) { return ::_read(fd, data, static_cast<unsigned>(size)); }
+long writeFile(int fd, const void* data, size_t size) { return ::_write(fd, data, static_cast<unsigned>(size)); }
+int truncateFile(int fd, long size) { return ::_chsize(fd, size); }
+long seekEnd(int fd) { return ::_lseek(fd, 0, SEEK_END); }
+int syncFile(int fd) { return ::_commit(fd); }
+#else
+int openFile(const char* path) { return ::open(path, O_RDWR | O_CREAT, 0644); }
+int closeFile(int fd) { return ::close(fd); }
+long readFile(int fd, void* data, size_t size) { return static_cast<long>(::read(fd, data, size)); }
+long writeFile(int fd, const void* data, size_t size) { return static_cast<long>(::write(fd, data, size)); }
+int truncateFile(int fd, long size) { return ::ftruncate(fd, size); }
+long seekEnd(int fd) { return static_cast<long>(::lseek(fd, 0, SEEK_END)); }
+#ifdef __APPLE__
+int syncFile(int fd) { return ::fsync(fd); }
+#else
+int syncFile(int fd) { return ::fdatasync(fd); }
+#endif
+#endif
+
+bool writeAll(int fd, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        long written = writeFile(fd, bytes, size);
+        if (written <= 0)
+            return false;
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// The whole file; journals hold a single game, so they stay small.
+bool readAll(const std::string& path, std::vector<uint8_t>& data) {
+#ifdef _WIN32
+    int fd = ::_open(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+#endif
+    if (fd < 0)
+        return false;
+
+    uint8_t buffer[4096];
+    long size;
+    while ((size = readFile(fd, buffer, sizeof(buffer))) > 0)
+        data.insert(data.end(), buffer, buffer + size);
+    closeFile(fd);
+    return size == 0;
+}
+
+}
+
+PicariaJournal::PicariaJournal()
+    : m_fd(-1),
+      m_sync(BatchSync),
+      m_batch(64),
+      m_milliseconds(100),
+      m_written(0),
+      m_durable(0),
+      m_syncs(0),
+      m_stopping(false) {
+}
+
+PicariaJournal::~PicariaJournal() {
+    this->close();
+}
+
+uint8_t PicariaJournal::check(uint8_t type, uint8_t from, uint8_t to) {
+    // An all zero entry fails, so a file extended with zeros by a crash
+    // reads as torn there.
+    return static_cast<uint8_t>((type * 31 + from * 7 + to) ^ 0xa5);
+}
+
+size_t PicariaJournal::replay(const std::vector<uint8_t>& data, PicariaGame& game, bool& started) {
+    started = false;
+    if (data.size() < headerSize || std::memcmp(data.data(), magic, sizeof(magic)) != 0 || data[4] != Version)
+        return 0;
+
+    size_t offset = headerSize;
+    for (; offset + entrySize <= data.size(); offset += entrySize) {
+        const uint8_t* entry = data.data() + offset;
+        if (entry[3] != PicariaJournal::check(entry[0], entry[1], entry[2]))
+            break;
+
+        int8_t from = static_cast<int8_t>(entry[1]);
+        int8_t to = static_cast<int8_t>(entry[2]);
+        bool applied = true;
+        switch (entry[0]) {
+        case StartEntry:
+            applied = to == PicariaBoard::NineHoles || to == PicariaBoard::ThirteenHoles;
+            if (applied)
+                game.reset(static_cast<PicariaBoard::Mode>(to));
+            started = started || applied;
+            break;
+        case PlayEntry:
+            applied = started && from >= -1 && from < PicariaBoard::HoleCount && to >= 0 && to < PicariaBoard::HoleCount &&
+                    game.play(from < 0 ? PicariaMove::drop(to) : PicariaMove::slide(from, to));
+            break;
+        case UndoEntry:
+            applied = started && !game.undo().isNull();
+            break;
+        case RedoEntry:
+            applied = started && !game.redo().isNull();
+            break;
+        default:
+            applied = false;
+        }
+        if (!applied)
+            break;
+    }
+    return offset;
+}
+
+bool PicariaJournal::restore(const std::string& path, PicariaGame& game) {
+    std::vector<uint8_t> data;
+    bool started = false;
+    return readAll(path, data) && PicariaJournal::replay(data, game, started) > 0 && started;
+}
+
+bool PicariaJournal::open(const std::string& path, Sync sync, int batch, int milliseconds) {
+    this->close();
+
+    std::vector<uint8_t> data;
+    readAll(path, data);
+
+    m_fd = openFile(path.c_str());
+    if (m_fd < 0)
+        return false;
+    m_sync = sync;
+    m_batch = batch > 0 ? batch : 1;
+    m_milliseconds = milliseconds > 0 ? milliseconds : 1;
+    m_written = 0;
+    m_durable = 0;
+    m_syncs = 0;
+    m_stopping = false;
+
+    // Keep the entries restore() applies and cut off the rest, a torn
+    // tail or an entry that does not apply, so that appends follow the
+    // game restore() gives.
+    PicariaGame game;
+    bool started = false;
+    size_t valid = PicariaJournal::replay(data, game, started);
+    if (valid == 0) {
+        uint8_t header[headerSize] = { 0 };
+        std::memcpy(header, magic, sizeof(magic));
+        header[4] = Version;
+        if (truncateFile(m_fd, 0) != 0 || seekEnd(m_fd) != 0 || !writeAll(m_fd, header, sizeof(header))) {
+            this->close();
+            return false;
+        }
+    }
+    else if (truncateFile(m_fd, static_cast<long>(valid)) != 0 || seekEnd(m_fd) != static_cast<long>(valid)) {
+        this->close();
+        return false;
+    }
+
+    if (m_sync == BatchSync)
+        m_flusher = std::thread(&PicariaJournal::flush, this);
+    return true;
+}
+
+void PicariaJournal::close() {
+    if (m_fd < 0)
+        return;
+
+    if (m_flusher.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        m_flusher.join();
+    }
+    if (m_written > m_durable) {
+        syncFile(m_fd);
+        m_durable = m_written;
+        ++m_syncs;
+    }
+    closeFile(m_fd);
+    m_fd = -1;
+}
+
+bool PicariaJournal::start(PicariaBoard::Mode mode) {
+    if (m_fd < 0)
+        return false;
+
+    // Only the new game matters from here on: drop the old one. Should
+    // the process die before the entry below is written, the journal
+    // reads as empty, which is a new game as well.
+    if (truncateFile(m_fd, static_cast<long>(headerSize)) != 0 || seekEnd(m_fd) != static_cast<long>(headerSize))
+        return false;
+    return this->append(StartEntry, 0, mode);
+}
+
+bool PicariaJournal::play(PicariaMove move) {
+    return this->append(PlayEntry, move.from, move.to);
+}
+
+bool PicariaJournal::undo() {
+    return this->append(UndoEntry);
+}
+
+bool PicariaJournal::redo() {
+    return this->append(RedoEntry);
+}
+
+bool PicariaJournal::append(Type type, int from, int to) {
+    if (m_fd < 0)
+        return false;
+
+    uint8_t entry[entrySize] = { type, static_cast<uint8_t>(from), static_cast<uint8_t>(to), 0 };
+    entry[3] = PicariaJournal::check(entry[0], entry[1], entry[2]);
+    if (!writeAll(m_fd, entry, sizeof(entry)))
+        return false;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    ++m_written;
+    if (m_sync == FullSync) {
+        lock.unlock();
+        bool synced = syncFile(m_fd) == 0;
+        lock.lock();
+        m_durable = m_written;
+        ++m_syncs;
+        return synced;
+    }
+    if (m_sync == BatchSync)
+        m_wake.notify_one();
+    return true;
+}
+
+void PicariaJournal::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this]() { return m_stopping || m_written > m_durable; });
+        if (m_written == m_durable)
+            return;
+
+        // Group commit: one sync for everything written until the batch
+        // fills or the interval ends.
+        m_wake.wait_for(lock, std::chrono::milliseconds(m_milliseconds), [this]() {
+            return m_stopping || m_written - m_durable >= static_cast<uint64_t>(m_batch);
+        });
+
+        uint64_t target = m_written;
+        lock.unlock();
+        syncFile(m_fd);
+        lock.lock();
+        m_durable = target;
+        ++m_syncs;
+    }
+}
+
+void PicariaJournal::sync() {
+    if (m_fd < 0)
+        return;
+
+    // Syncing here rather than waking the flusher: the caller waits for
+    // the disk either way.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    uint64_t target = m_written;
+    lock.unlock();
+    syncFile(m_fd);
+    lock.lock();
+    m_durable = std::max(m_durable, target);
+    ++m_syncs;
+}
+
+uint64_t PicariaJournal::entries() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_written;
+}
+
+uint64_t PicariaJournal::syncs() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_syncs;
+}
@@ -0,0 +1,97 @@
+#ifndef PICARIAJOURNAL_H
+#define PICARIAJOURNAL_H
+
+#include "PicariaGame.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Append-only log of the game in progress, so that it survives the
+// process. Every change is written to the file at once, which is enough
+// if the process dies; reaching the disk, which survives a power cut
+// too, is up to the sync mode:
+//
+//   NoSync       the system writes the file back when it likes
+//   BatchSync    a background thread syncs after batch entries or after
+//                milliseconds, whichever comes first, so the caller never
+//                waits for the disk
+//   FullSync     every entry is synced before append returns
+//
+// Layout: magic "PCJL", version, three zero bytes; then four byte
+// entries of type, origin, destination and check byte. A new game
+// truncates the file, so it never holds more than one game. Reading
+// stops at the first entry that is torn or fails its check.
+class PicariaJournal {
+public:
+    static const uint8_t Version = 1;
+
+    enum Sync {
+        NoSync,
+        BatchSync,
+        FullSync
+    };
+
+    PicariaJournal();
+    ~PicariaJournal();
+
+    PicariaJournal(const PicariaJournal&) = delete;
+    PicariaJournal& operator=(const PicariaJournal&) = delete;
+
+    // Replays the journal into game. False when there is no journal or
+    // it holds no game.
+    static bool restore(const std::string& path, PicariaGame& game);
+
+    // Opens the journal for appending, after its last valid entry.
+    bool open(const std::string& path, Sync sync = BatchSync, int batch = 64, int milliseconds = 100);
+    // Syncs what is left and closes.
+    void close();
+    bool isOpen() const { return m_fd >= 0; }
+
+    bool start(PicariaBoard::Mode mode);
+    bool play(PicariaMove move);
+    bool undo();
+    bool redo();
+
+    // Returns once every entry so far is on the disk.
+    void sync();
+
+    uint64_t entries() const;
+    uint64_t syncs() const;
+
+private:
+    enum Type : uint8_t {
+        StartEntry = 1,
+        PlayEntry = 2,
+        UndoEntry = 3,
+        RedoEntry = 4
+    };
+
+    int m_fd;
+    Sync m_sync;
+    int m_batch;
+    int m_milliseconds;
+
+    // Entries written to the file and entries known to be on the disk.
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    uint64_t m_written;
+    uint64_t m_durable;
+    uint64_t m_syncs;
+    bool m_stopping;
+    std::thread m_flusher;
+
+    bool append(Type type, int from = 0, int to = 0);
+    void flush();
+
+    // Applies the entries of a whole journal file to game; returns the
+    // size of the part applied, or 0 for a bad header.
+    static size_t replay(const std::vector<uint8_t>& data, PicariaGame& game, bool& started);
+    static uint8_t check(uint8_t type, uint8_t from, uint8_t to);
+
+};
+
+#endif // PICARIAJOURNAL_H
@@ -0,0 +1,195 @@
+#include "PicariaMcts.h"
+#include "PicariaRules.h"
+
+#include <cmath>
+#include <thread>
+
+namespace {
+
+// Longest playout before it is scored as a draw.
+const int maxPlayout = 128;
+const float exploration = 1.4f;
+
+uint64_t next(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545f4914f6cdd1dull;
+}
+
+}
+
+PicariaMcts::PicariaMcts(int threads, size_t nodesPerThread)
+    : m_threads(1),
+      m_nodesPerThread(nodesPerThread),
+      m_seed(0x4d435453ull),
+      m_playoutLimit(0),
+      m_playouts(0),
+      m_seconds(0) {
+    this->setThreads(threads);
+}
+
+void PicariaMcts::setThreads(int threads) {
+    if (threads <= 0)
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    m_threads = threads > 0 ? threads : 1;
+}
+
+PicariaMove PicariaMcts::think(const PicariaBoard& board, int milliseconds) {
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start + std::chrono::milliseconds(milliseconds);
+
+    PicariaMoveList list = board.moves();
+    m_playouts = 0;
+    m_seconds = 0;
+    if (list.count <= 1)
+        return list.count == 1 ? list[0] : PicariaMove();
+
+    std::vector<std::vector<Result>> results(m_threads);
+    std::vector<uint64_t> playouts(m_threads, 0);
+    // The limit is shared evenly between the trees.
+    const uint64_t limit = m_playoutLimit == 0 ? 0 : (m_playoutLimit + m_threads - 1) / m_threads;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < m_threads; ++i) {
+        uint64_t seed = m_seed + 0x9e3779b97f4a7c15ull * (i + 1);
+        workers.emplace_back([&, i, seed]() {
+            playouts[i] = picariaDispatch(board.mode(), [&](auto rules) {
+                return this->grow<decltype(rules)>(board, deadline, limit, m_nodesPerThread, seed, results[i]);
+            });
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    m_seed = next(m_seed);
+
+    // Sum the visits of every root move over all trees.
+    PicariaMove best = list[0];
+    uint64_t bestVisits = 0;
+    for (PicariaMove move : list) {
+        uint64_t visits = 0;
+        for (const std::vector<Result>& tree : results)
+            for (const Result& result : tree)
+                if (result.move == move)
+                    visits += result.visits;
+        if (visits > bestVisits) {
+            best = move;
+            bestVisits = visits;
+        }
+    }
+
+    for (uint64_t count : playouts)
+        m_playouts += count;
+    m_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    return best;
+}
+
+template <typename Rules>
+uint64_t PicariaMcts::grow(const PicariaBoard& board, Clock::time_point deadline, uint64_t limit, size_t capacity,
+                           uint64_t seed, std::vector<Result>& results) const {
+    // Reserved up front: nodes are never moved, so references stay valid.
+    std::vector<Node> tree;
+    tree.reserve(capacity);
+    tree.push_back(Node{ board, PicariaMove(), -1, 0, -1, 0, 0.0f });
+
+    std::vector<int32_t> path;
+    uint64_t random = seed | 1;
+    uint64_t playouts = 0;
+
+    do {
+        for (int batch = 0; batch < 64 && (limit == 0 || playouts < limit); ++batch) {
+            // Selection: follow the best child by UCT down to a leaf,
+            // expanding a leaf once it has been visited.
+            int32_t index = 0;
+            path.clear();
+            path.push_back(index);
+
+            while (tree[index].winner < 0) {
+                Node& node = tree[index];
+                if (node.firstChild < 0) {
+                    if ((node.visits == 0 && index != 0) || tree.size() + PicariaMoveList::Capacity > capacity)
+                        break;
+
+                    PicariaMoveList list;
+                    Rules::generate(node.board, list);
+                    node.firstChild = static_cast<int32_t>(tree.size());
+                    node.childCount = static_cast<uint8_t>(list.count);
+                    for (PicariaMove move : list) {
+                        PicariaBoard child = node.board;
+                        child.play(move);
+                        tree.push_back(Node{ child, move, PicariaMcts::winner<Rules>(child, move), 0, -1, 0, 0.0f });
+                    }
+                }
+
+                const float logVisits = std::log(static_cast<float>(node.visits + 1));
+                int32_t best = node.firstChild;
+                float bestValue = -1.0f;
+                for (int32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child) {
+                    const Node& candidate = tree[child];
+                    if (candidate.visits == 0) {
+                        best = child;
+                        break;
+                    }
+                    float value = candidate.score / candidate.visits +
+                            exploration * std::sqrt(logVisits / candidate.visits);
+                    if (value > bestValue) {
+                        best = child;
+                        bestValue = value;
+                    }
+                }
+
+                index = best;
+                path.push_back(index);
+                if (tree[index].visits == 0)
+                    break;
+            }
+
+            // Simulation, then backpropagation to every node on the path.
+            const Node& leaf = tree[index];
+            int winner = leaf.winner >= 0 ? leaf.winner : PicariaMcts::playout<Rules>(leaf.board, random);
+            for (int32_t i : path) {
+                Node& node = tree[i];
+                int mover = PicariaBoard::opponent(node.board.player());
+                node.visits++;
+                node.score += winner < 0 ? 0.5f : winner == mover ? 1.0f : 0.0f;
+            }
+            ++playouts;
+        }
+    } while (!this->isStopped() && Clock::now() < deadline && (limit == 0 || playouts < limit));
+
+    const Node& root = tree[0];
+    for (int32_t child = root.firstChild; child < root.firstChild + root.childCount; ++child)
+        results.push_back(Result{ tree[child].move, tree[child].visits });
+
+    return playouts;
+}
+
+// Plays random moves until someone wins; returns the winner, or -1 for a
+// playout too long to be decided.
+template <typename Rules>
+int PicariaMcts::playout(PicariaBoard board, uint64_t& random) {
+    for (int ply = 0; ply < maxPlayout; ++ply) {
+        PicariaMoveList list;
+        Rules::generate(board, list);
+        PicariaBoard::Player player = board.player();
+        if (list.count == 0)
+            return PicariaBoard::opponent(player);
+
+        PicariaMove move = list[static_cast<int>(next(random) % list.count)];
+        board.play(move);
+        if (Rules::hasLineThrough(board.pieces(player), move.to))
+            return player;
+    }
+    return -1;
+}
+
+// The player who made move if it ended the game, otherwise -1.
+template <typename Rules>
+int8_t PicariaMcts::winner(const PicariaBoard& child, PicariaMove move) {
+    PicariaBoard::Player player = child.player();
+    PicariaBoard::Player mover = PicariaBoard::opponent(player);
+    if (Rules::hasLineThrough(child.pieces(mover), move.to) ||
+            Rules::targets(child.pieces(player), child.occupied(), child.phase()) == 0)
+        return static_cast<int8_t>(mover);
+    return -1;
+}
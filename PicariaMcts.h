@@ -0,0 +1,75 @@
+#ifndef PICARIAMCTS_H
+#define PICARIAMCTS_H
+
+#include "PicariaBoard.h"
+#include "PicariaEngine.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Monte Carlo tree search with root parallelism: every thread grows its
+// own tree from the same root with its own random playouts, and the root
+// visit counts are summed at the end. Threads share nothing while they
+// think, so throughput scales with the number of cores.
+class PicariaMcts : public PicariaEngine {
+public:
+    // threads <= 0 uses one thread per core. Each tree holds at most
+    // nodesPerThread nodes; once full, playouts start from its leaves.
+    explicit PicariaMcts(int threads = 0, size_t nodesPerThread = 1 << 18);
+
+    PicariaMove think(const PicariaBoard& board, int milliseconds) override;
+
+    int threads() const { return m_threads; }
+    void setThreads(int threads);
+
+    // Playouts are reproducible for a given seed and thread count.
+    void setSeed(uint64_t seed) { m_seed = seed; }
+
+    // Ends think() after about this many playouts, whatever time is left;
+    // 0 means no limit. With a limit, the move played only depends on the
+    // seed and the thread count, not on the speed of the machine.
+    void setPlayoutLimit(uint64_t playouts) { m_playoutLimit = playouts; }
+    uint64_t playoutLimit() const { return m_playoutLimit; }
+
+    // Statistics of the last think().
+    uint64_t playouts() const { return m_playouts; }
+    double playoutsPerSecond() const { return m_seconds > 0 ? m_playouts / m_seconds : 0; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Node {
+        PicariaBoard board;
+        PicariaMove move;
+        int8_t winner;          // -1 while the game goes on
+        uint8_t childCount;
+        int32_t firstChild;     // -1 until expanded
+        uint32_t visits;
+        float score;            // for the player who made move
+    };
+
+    struct Result {
+        PicariaMove move;
+        uint32_t visits;
+    };
+
+    int m_threads;
+    size_t m_nodesPerThread;
+    uint64_t m_seed;
+    uint64_t m_playoutLimit;
+    uint64_t m_playouts;
+    double m_seconds;
+
+    template <typename Rules>
+    uint64_t grow(const PicariaBoard& board, Clock::time_point deadline, uint64_t limit, size_t capacity,
+                  uint64_t seed, std::vector<Result>& results) const;
+    template <typename Rules>
+    static int playout(PicariaBoard board, uint64_t& random);
+    template <typename Rules>
+    static int8_t winner(const PicariaBoard& child, PicariaMove move);
+
+};
+
+#endif // PICARIAMCTS_H
@@ -0,0 +1,43 @@
+#ifndef PICARIAMOVE_H
+#define PICARIAMOVE_H
+
+#include <cstdint>
+
+// A drop onto an empty hole, or a slide of a piece to a neighbouring hole.
+struct PicariaMove {
+    int8_t from;
+    int8_t to;
+
+    PicariaMove() : from(-1), to(-1) {}
+
+    static PicariaMove drop(int to) { return PicariaMove(-1, to); }
+    static PicariaMove slide(int from, int to) { return PicariaMove(from, to); }
+
+    bool isNull() const { return to < 0; }
+    bool isDrop() const { return from < 0 && to >= 0; }
+
+    bool operator==(const PicariaMove& other) const { return from == other.from && to == other.to; }
+    bool operator!=(const PicariaMove& other) const { return !(*this == other); }
+
+private:
+    PicariaMove(int from, int to) : from(static_cast<int8_t>(from)), to(static_cast<int8_t>(to)) {}
+
+};
+
+// Every move of one position. A position has at most 13 drops, or
+// 3 pieces times 8 neighbours slides.
+struct PicariaMoveList {
+    static const int Capacity = 24;
+
+    PicariaMove moves[Capacity];
+    int count = 0;
+
+    void append(PicariaMove move) { moves[count++] = move; }
+
+    const PicariaMove* begin() const { return moves; }
+    const PicariaMove* end() const { return moves + count; }
+    PicariaMove& operator[](int index) { return moves[index]; }
+    const PicariaMove& operator[](int index) const { return moves[index]; }
+};
+
+#endif // PICARIAMOVE_H
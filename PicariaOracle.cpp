@@ -0,0 +1,41 @@
+#include "PicariaOracle.h"
+#include "PicariaBook.h"
+#include "PicariaTablebase.h"
+
+#include <utility>
+
+PicariaOracle::PicariaOracle(PicariaEngine* engine,
+                             std::shared_ptr<const PicariaTablebase> tablebase,
+                             std::shared_ptr<const PicariaBook> book)
+    : m_engine(engine),
+      m_tablebase(std::move(tablebase)),
+      m_book(std::move(book)) {
+}
+
+PicariaOracle::~PicariaOracle() {
+}
+
+PicariaMove PicariaOracle::think(const PicariaBoard& board, int milliseconds) {
+    PicariaMove move;
+    if (m_book)
+        move = m_book->move(board);
+    if (move.isNull() && m_tablebase)
+        move = m_tablebase->bestMove(board);
+    if (move.isNull())
+        move = m_engine->think(board, milliseconds);
+    return move;
+}
+
+void PicariaOracle::clear() {
+    m_engine->clear();
+}
+
+void PicariaOracle::stop() {
+    PicariaEngine::stop();
+    m_engine->stop();
+}
+
+void PicariaOracle::resume() {
+    PicariaEngine::resume();
+    m_engine->resume();
+}
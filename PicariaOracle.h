@@ -0,0 +1,36 @@
+#ifndef PICARIAORACLE_H
+#define PICARIAORACLE_H
+
+#include "PicariaEngine.h"
+
+#include <memory>
+
+class PicariaBook;
+class PicariaTablebase;
+
+// Plays from precomputed knowledge: the opening book first, then the
+// tablebase, and only asks the wrapped engine about positions neither
+// knows. Either source may be missing.
+class PicariaOracle : public PicariaEngine {
+public:
+    // Takes ownership of the engine.
+    PicariaOracle(PicariaEngine* engine,
+                  std::shared_ptr<const PicariaTablebase> tablebase,
+                  std::shared_ptr<const PicariaBook> book);
+    virtual ~PicariaOracle();
+
+    PicariaMove think(const PicariaBoard& board, int milliseconds) override;
+    void clear() override;
+    void stop() override;
+    void resume() override;
+
+    PicariaEngine* engine() const { return m_engine.get(); }
+
+private:
+    std::unique_ptr<PicariaEngine> m_engine;
+    std::shared_ptr<const PicariaTablebase> m_tablebase;
+    std::shared_ptr<const PicariaBook> m_book;
+
+};
+
+#endif // PICARIAORACLE_H
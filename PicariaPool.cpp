@@ -0,0 +1,89 @@
+#include "PicariaPool.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// The indices [begin, end) one thread has left. Aligned so that threads
+// taking from their own share do not contend on a cache line.
+struct alignas(64) Share {
+    std::mutex mutex;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+bool take(Share& share, size_t& index) {
+    std::lock_guard<std::mutex> lock(share.mutex);
+    if (share.begin == share.end)
+        return false;
+    index = share.begin++;
+    return true;
+}
+
+// Moves the back half of victim's share, at least one index, to thief.
+bool steal(Share& victim, Share& thief) {
+    size_t begin;
+    size_t end;
+    {
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.begin == victim.end)
+            return false;
+        end = victim.end;
+        begin = victim.begin + (victim.end - victim.begin) / 2;
+        victim.end = begin;
+    }
+
+    std::lock_guard<std::mutex> lock(thief.mutex);
+    thief.begin = begin;
+    thief.end = end;
+    return true;
+}
+
+}
+
+PicariaPool::PicariaPool(int threads)
+    : m_threads(threads) {
+    if (m_threads <= 0)
+        m_threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (m_threads <= 0)
+        m_threads = 1;
+}
+
+void PicariaPool::run(size_t count, const std::function<void(size_t index, int thread)>& task) {
+    const int threads = static_cast<int>(std::min<size_t>(static_cast<size_t>(m_threads), std::max<size_t>(count, 1)));
+
+    std::unique_ptr<Share[]> shares(new Share[threads]);
+    for (int i = 0; i < threads; ++i) {
+        shares[i].begin = count * i / threads;
+        shares[i].end = count * (i + 1) / threads;
+    }
+
+    auto work = [&](int thread) {
+        for (;;) {
+            size_t index;
+            if (take(shares[thread], index)) {
+                task(index, thread);
+                continue;
+            }
+
+            // A share only grows when its own thread steals into it, so a
+            // sweep finding nothing means every task left is taken.
+            bool stolen = false;
+            for (int i = 1; i < threads && !stolen; ++i)
+                stolen = steal(shares[(thread + i) % threads], shares[thread]);
+            if (!stolen)
+                return;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; ++i)
+        workers.emplace_back(work, i);
+    work(0);
+    for (std::thread& worker : workers)
+        worker.join();
+}
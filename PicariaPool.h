@@ -0,0 +1,29 @@
+#ifndef PICARIAPOOL_H
+#define PICARIAPOOL_H
+
+#include <cstddef>
+#include <functional>
+
+// Runs many independent tasks on every core. Each thread starts with an
+// equal share of the task indices and takes them one by one from the
+// front; a thread that runs out steals the back half of another thread's
+// share. Uneven tasks, such as games of very different lengths, keep all
+// threads busy until the last few are left.
+class PicariaPool {
+public:
+    // threads <= 0 uses one thread per core.
+    explicit PicariaPool(int threads = 0);
+
+    int threads() const { return m_threads; }
+
+    // Calls task(index, thread) once for every index below count, and
+    // returns when all are done. thread is below threads(): per thread
+    // state indexed by it needs no locks.
+    void run(size_t count, const std::function<void(size_t index, int thread)>& task);
+
+private:
+    int m_threads;
+
+};
+
+#endif // PICARIAPOOL_H
@@ -0,0 +1,132 @@
+#include "PicariaProtocol.h"
+#include "PicariaMcts.h"
+#include "PicariaOracle.h"
+#include "PicariaRecord.h"
+#include "PicariaSearch.h"
+
+#include <cstdlib>
+#include <istream>
+#include <ostream>
+#include <sstream>
+
+// Thinking time of "go" without an argument, in milliseconds.
+static const int defaultTime = 1000;
+
+PicariaProtocol::PicariaProtocol(std::shared_ptr<const PicariaTablebase> tablebase,
+                                 std::shared_ptr<const PicariaBook> book)
+    : m_tablebase(std::move(tablebase)),
+      m_book(std::move(book)),
+      m_quitting(false) {
+    this->setEngine(false);
+}
+
+PicariaProtocol::~PicariaProtocol() {
+}
+
+std::string PicariaProtocol::execute(const std::string& line) {
+    std::istringstream stream(line);
+    std::string command;
+    std::string argument;
+    std::string extra;
+    stream >> command >> argument >> extra;
+
+    if (command.empty())
+        return "error empty command";
+    if (!extra.empty())
+        return "error too many arguments";
+
+    if (command == "mode") {
+        if (argument != "9" && argument != "13")
+            return "error mode must be 9 or 13";
+        m_game.reset(argument == "9" ? PicariaBoard::NineHoles : PicariaBoard::ThirteenHoles);
+        m_engine->clear();
+        return "ok";
+    }
+    if (command == "new") {
+        m_game.reset(m_game.mode());
+        m_engine->clear();
+        return "ok";
+    }
+    if (command == "move") {
+        PicariaMove move = PicariaRecord::parse(argument);
+        if (move.isNull())
+            return "error bad move " + argument;
+        if (!m_game.play(move))
+            return "error illegal move " + argument;
+        return "ok";
+    }
+    if (command == "undo")
+        return m_game.undo().isNull() ? "error nothing to undo" : "ok";
+    if (command == "redo")
+        return m_game.redo().isNull() ? "error nothing to redo" : "ok";
+    if (command == "go") {
+        int milliseconds = argument.empty() ? defaultTime : std::atoi(argument.c_str());
+        if (milliseconds <= 0)
+            return "error bad time " + argument;
+        if (m_game.isOver())
+            return "ok none";
+        return "ok " + PicariaRecord::format(m_engine->think(m_game.board(), milliseconds));
+    }
+    if (command == "engine") {
+        if (argument != "search" && argument != "mcts")
+            return "error engine must be search or mcts";
+        this->setEngine(argument == "mcts");
+        return "ok";
+    }
+    if (command == "moves") {
+        std::string reply = "ok";
+        if (!m_game.isOver())
+            for (PicariaMove move : m_game.board().moves())
+                reply += " " + PicariaRecord::format(move);
+        return reply;
+    }
+    if (command == "status")
+        return this->status();
+    if (command == "quit") {
+        m_quitting = true;
+        return "ok";
+    }
+    return "error unknown command " + command;
+}
+
+void PicariaProtocol::run(std::istream& input, std::ostream& output) {
+    std::string line;
+    while (!m_quitting && std::getline(input, line))
+        output << this->execute(line) << std::endl;
+}
+
+void PicariaProtocol::setEngine(bool mcts) {
+    PicariaEngine* engine = mcts ? static_cast<PicariaEngine*>(new PicariaMcts) : new PicariaSearch(4 << 20, 0);
+    if (m_tablebase || m_book)
+        engine = new PicariaOracle(engine, m_tablebase, m_book);
+    m_engine.reset(engine);
+}
+
+std::string PicariaProtocol::status() const {
+    const PicariaBoard& board = m_game.board();
+
+    std::string result = "playing";
+    if (m_game.isOver())
+        result = m_game.winner() == PicariaBoard::RedPlayer ? "red" : "blue";
+
+    std::string holes;
+    for (int id = 0; id < PicariaBoard::HoleCount; ++id) {
+        if (!board.isHole(id))
+            holes += '-';
+        else if (board.hasPiece(PicariaBoard::RedPlayer, id))
+            holes += 'r';
+        else if (board.hasPiece(PicariaBoard::BluePlayer, id))
+            holes += 'b';
+        else
+            holes += '.';
+    }
+
+    std::ostringstream stream;
+    stream << "ok mode " << (board.mode() == PicariaBoard::NineHoles ? 9 : 13)
+           << " player " << (board.player() == PicariaBoard::RedPlayer ? "red" : "blue")
+           << " phase " << (board.phase() == PicariaBoard::DropPhase ? "drop" : "move")
+           << " ply " << m_game.ply()
+           << " result " << result
+           << " holes " << holes;
+    return stream.str();
+}
@@ -0,0 +1,60 @@
+#ifndef PICARIAPROTOCOL_H
+#define PICARIAPROTOCOL_H
+
+#include "PicariaEngine.h"
+#include "PicariaGame.h"
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+class PicariaBook;
+class PicariaTablebase;
+
+// Line protocol to play and analyse games without a window. Every command
+// is one line and gets exactly one reply line, "ok ..." or "error ...":
+//
+//   mode 9|13              new game on the given board
+//   new                    new game on the same board
+//   move <m>               plays m: "7" drops on hole 7, "7-2" slides,
+//                          as in PicariaRecord's text format
+//   undo | redo            takes back or plays again the last move
+//   go [milliseconds]      the engine's move for the side to move, not
+//                          played; "ok none" at the end of the game
+//   engine search|mcts     switches the engine
+//   moves                  the legal moves
+//   status                 mode, side to move, phase, ply, result
+//                          (playing, or the winner: red or blue) and
+//                          the holes as one letter each: r, b, . or -
+//   quit                   ends run()
+//
+// Holes are numbered from 1, as on the board shown to users.
+class PicariaProtocol {
+public:
+    PicariaProtocol(std::shared_ptr<const PicariaTablebase> tablebase = nullptr,
+                    std::shared_ptr<const PicariaBook> book = nullptr);
+    ~PicariaProtocol();
+
+    const PicariaGame& game() const { return m_game; }
+
+    // Executes one command and returns its reply, without a newline.
+    std::string execute(const std::string& line);
+    bool isQuitting() const { return m_quitting; }
+
+    // Answers commands from input until quit or the end of input. Replies
+    // are flushed one by one, so another program can drive the protocol.
+    void run(std::istream& input, std::ostream& output);
+
+private:
+    PicariaGame m_game;
+    std::shared_ptr<const PicariaTablebase> m_tablebase;
+    std::shared_ptr<const PicariaBook> m_book;
+    std::unique_ptr<PicariaEngine> m_engine;
+    bool m_quitting;
+
+    void setEngine(bool mcts);
+    std::string status() const;
+
+};
+
+#endif // PICARIAPROTOCOL_H
@@ -0,0 +1,304 @@
+#include "PicariaRecord.h"
+
+#include <cstring>
+
+namespace {
+
+const char magic[4] = { 'P', 'C', 'G', 'R' };
+const size_t headerSize = 8;
+
+const char* const results[] = { "*", "1-0", "0-1", "1/2-1/2" };
+
+bool parseHole(const char* text, size_t size, int& id) {
+    if (size == 0 || size > 2 || text[0] < '0' || text[0] > '9' || (size == 2 && (text[1] < '0' || text[1] > '9')))
+        return false;
+    id = (size == 2 ? (text[0] - '0') * 10 + text[1] - '0' : text[0] - '0') - 1;
+    return id >= 0 && id < PicariaBoard::HoleCount;
+}
+
+}
+
+PicariaRecord::Error PicariaRecord::validate(size_t* index) const {
+    PicariaBoard board(mode);
+    PicariaBoard::Player winner = PicariaBoard::RedPlayer;
+    bool over = false;
+
+    for (size_t i = 0; i < moves.size(); ++i) {
+        PicariaMove move = moves[i];
+        if (over || !board.canPlay(move)) {
+            if (index)
+                *index = i;
+            return IllegalMove;
+        }
+
+        // A line through the hole moved to, or a blocked opponent, ends the
+        // game, as after a click in the user interface.
+        winner = board.player();
+        board.play(move);
+        over = board.hasLineThrough(winner, move.to) || !board.hasMoves();
+    }
+
+    if (over)
+        return result == (winner == PicariaBoard::RedPlayer ? RedWin : BlueWin) ? NoError : WrongResult;
+    return result == Unfinished || result == Draw ? NoError : WrongResult;
+}
+
+std::string PicariaRecord::toText() const {
+    std::string text = mode == PicariaBoard::NineHoles ? "9" : "13";
+    for (PicariaMove move : moves)
+        text += " " + PicariaRecord::format(move);
+    text += " ";
+    text += results[result];
+    return text;
+}
+
+bool PicariaRecord::fromText(const std::string& line) {
+    // Tokens are split in place: bulk validation of text files is bound
+    // by this loop.
+    const char* text = line.c_str();
+    std::string token;
+    auto nextToken = [&text, &token]() {
+        while (*text == ' ' || *text == '\t' || *text == '\r')
+            ++text;
+        const char* begin = text;
+        while (*text && *text != ' ' && *text != '\t' && *text != '\r')
+            ++text;
+        token.assign(begin, text);
+        return !token.empty();
+    };
+
+    if (!nextToken() || (token != "9" && token != "13"))
+        return false;
+    mode = token == "9" ? PicariaBoard::NineHoles : PicariaBoard::ThirteenHoles;
+    moves.clear();
+
+    // The last token is the result; everything before it must be moves.
+    while (nextToken()) {
+        for (int i = 0; i < 4; ++i) {
+            if (token == results[i]) {
+                result = static_cast<Result>(i);
+                return !nextToken();
+            }
+        }
+        PicariaMove move = PicariaRecord::parse(token);
+        if (move.isNull() || moves.size() >= MaxMoves)
+            return false;
+        moves.push_back(move);
+    }
+    return false;
+}
+
+std::string PicariaRecord::format(PicariaMove move) {
+    if (move.isNull())
+        return "none";
+    if (move.isDrop())
+        return std::to_string(move.to + 1);
+    return std::to_string(move.from + 1) + "-" + std::to_string(move.to + 1);
+}
+
+PicariaMove PicariaRecord::parse(const std::string& text) {
+    int from;
+    int to;
+    size_t dash = text.find('-');
+    if (dash == std::string::npos)
+        return parseHole(text.c_str(), text.size(), to) ? PicariaMove::drop(to) : PicariaMove();
+    if (parseHole(text.c_str(), dash, from) && parseHole(text.c_str() + dash + 1, text.size() - dash - 1, to))
+        return PicariaMove::slide(from, to);
+    return PicariaMove();
+}
+
+PicariaRecordWriter::PicariaRecordWriter()
+    : m_file(nullptr),
+      m_format(PicariaRecord::BinaryFormat),
+      m_failed(false) {
+}
+
+PicariaRecordWriter::~PicariaRecordWriter() {
+    this->close();
+}
+
+bool PicariaRecordWriter::open(const std::string& path, PicariaRecord::Format format) {
+    this->close();
+    m_file = std::fopen(path.c_str(), format == PicariaRecord::BinaryFormat ? "wb" : "w");
+    if (!m_file)
+        return false;
+    std::setvbuf(m_file, nullptr, _IOFBF, 1 << 20);
+    m_format = format;
+    m_failed = false;
+
+    if (format == PicariaRecord::BinaryFormat) {
+        uint8_t header[headerSize] = { 0 };
+        std::memcpy(header, magic, sizeof(magic));
+        header[4] = PicariaRecord::Version;
+        m_failed = std::fwrite(header, 1, sizeof(header), m_file) != sizeof(header);
+    }
+    return !m_failed;
+}
+
+bool PicariaRecordWriter::write(const PicariaRecord& record) {
+    if (!m_file || m_failed || record.moves.size() > PicariaRecord::MaxMoves)
+        return false;
+
+    if (m_format == PicariaRecord::TextFormat) {
+        std::string line = record.toText() + "\n";
+        m_failed = std::fwrite(line.data(), 1, line.size(), m_file) != line.size();
+        return !m_failed;
+    }
+
+    m_bytes.clear();
+    for (size_t count = record.moves.size(); ; count >>= 7) {
+        m_bytes.push_back(static_cast<uint8_t>((count & 0x7f) | (count >= 0x80 ? 0x80 : 0)));
+        if (count < 0x80)
+            break;
+    }
+    m_bytes.push_back(static_cast<uint8_t>(record.mode | record.result << 1));
+    for (PicariaMove move : record.moves)
+        m_bytes.push_back(static_cast<uint8_t>((move.from + 1) << 4 | move.to));
+
+    m_failed = std::fwrite(m_bytes.data(), 1, m_bytes.size(), m_file) != m_bytes.size();
+    return !m_failed;
+}
+
+bool PicariaRecordWriter::close() {
+    if (!m_file)
+        return !m_failed;
+    m_failed = std::fclose(m_file) != 0 || m_failed;
+    m_file = nullptr;
+    return !m_failed;
+}
+
+PicariaRecordReader::PicariaRecordReader()
+    : m_file(nullptr),
+      m_format(PicariaRecord::BinaryFormat),
+      m_position(0),
+      m_size(0),
+      m_count(0) {
+}
+
+PicariaRecordReader::~PicariaRecordReader() {
+    if (m_file)
+        std::fclose(m_file);
+}
+
+bool PicariaRecordReader::open(const std::string& path) {
+    if (m_file)
+        std::fclose(m_file);
+    m_file = std::fopen(path.c_str(), "rb");
+    m_buffer.resize(BufferSize);
+    m_position = 0;
+    m_size = 0;
+    m_count = 0;
+    m_error.clear();
+    if (!m_file)
+        return this->fail("cannot open " + path);
+
+    // Anything without the binary magic is read as text.
+    m_format = PicariaRecord::TextFormat;
+    if (this->fill(headerSize) && std::memcmp(m_buffer.data(), magic, sizeof(magic)) == 0) {
+        if (m_buffer[4] != PicariaRecord::Version)
+            return this->fail("unknown version " + std::to_string(m_buffer[4]));
+        m_format = PicariaRecord::BinaryFormat;
+        m_position = headerSize;
+    }
+    return true;
+}
+
+bool PicariaRecordReader::read(PicariaRecord& record) {
+    if (!m_file || !m_error.empty())
+        return false;
+    bool read = m_format == PicariaRecord::BinaryFormat ? this->readBinary(record) : this->readText(record);
+    if (read)
+        ++m_count;
+    return read;
+}
+
+bool PicariaRecordReader::fill(size_t bytes) {
+    if (m_size - m_position >= bytes)
+        return true;
+
+    std::memmove(m_buffer.data(), m_buffer.data() + m_position, m_size - m_position);
+    m_size -= m_position;
+    m_position = 0;
+    while (m_size < bytes) {
+        size_t read = std::fread(m_buffer.data() + m_size, 1, m_buffer.size() - m_size, m_file);
+        if (read == 0)
+            return false;
+        m_size += read;
+    }
+    return true;
+}
+
+bool PicariaRecordReader::readBinary(PicariaRecord& record) {
+    if (!this->fill(1))
+        return false;
+
+    // The move count takes at most three varint bytes below MaxMoves.
+    size_t count = 0;
+    for (int shift = 0; ; shift += 7) {
+        if (shift > 14 || !this->fill(1))
+            return this->fail("bad move count");
+        uint8_t byte = m_buffer[m_position++];
+        count |= static_cast<size_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            break;
+    }
+    if (count > PicariaRecord::MaxMoves || !this->fill(count + 1))
+        return this->fail("truncated game");
+
+    uint8_t flags = m_buffer[m_position++];
+    if (flags & ~0x07)
+        return this->fail("bad flags");
+    record.mode = static_cast<PicariaBoard::Mode>(flags & 1);
+    record.result = static_cast<PicariaRecord::Result>(flags >> 1);
+
+    record.moves.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t byte = m_buffer[m_position++];
+        int from = (byte >> 4) - 1;
+        int to = byte & 0x0f;
+        if (from >= PicariaBoard::HoleCount || to >= PicariaBoard::HoleCount)
+            return this->fail("bad move");
+        record.moves[i] = from < 0 ? PicariaMove::drop(to) : PicariaMove::slide(from, to);
+    }
+    return true;
+}
+
+bool PicariaRecordReader::readText(PicariaRecord& record) {
+    for (;;) {
+        // Find the end of the line, reading more while there is room.
+        size_t end = m_position;
+        for (;;) {
+            const void* newline = std::memchr(m_buffer.data() + end, '\n', m_size - end);
+            if (newline) {
+                end = static_cast<size_t>(static_cast<const uint8_t*>(newline) - m_buffer.data());
+                break;
+            }
+            size_t length = m_size - m_position;
+            if (length == m_buffer.size())
+                return this->fail("line too long");
+            bool more = this->fill(length + 1);
+            end = m_size;
+            if (!more) {
+                if (m_position == m_size)
+                    return false;
+                break;
+            }
+            end = m_position + length;
+        }
+
+        std::string line(reinterpret_cast<const char*>(m_buffer.data() + m_position), end - m_position);
+        m_position = end < m_size ? end + 1 : end;
+
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+        if (!record.fromText(line))
+            return this->fail("bad line: " + line);
+        return true;
+    }
+}
+
+bool PicariaRecordReader::fail(const std::string& error) {
+    m_error = error;
+    return false;
+}
@@ -0,0 +1,130 @@
+#ifndef PICARIARECORD_H
+#define PICARIARECORD_H
+
+#include "PicariaBoard.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// A recorded game: the board mode, every drop and slide from the start
+// position, and the result the recorder claimed.
+//
+// Games are stored one after another, in one of two formats:
+//
+//   binary   magic "PCGR", version, three zero bytes; then per game the
+//            move count as a base 128 varint, a flags byte (bit 0 the
+//            mode, bits 1-2 the result) and one byte per move: the
+//            origin hole plus one in the high nibble, 0 for a drop, and
+//            the destination hole in the low nibble
+//   text     one game per line: 9 or 13, the moves as in the user
+//            interface ("7" drops on hole 7, "7-2" slides), then the
+//            result: 1-0, 0-1, 1/2-1/2 or *. Blank lines and lines
+//            starting with # are skipped.
+//
+// Holes in the text format are numbered from 1, as on the board shown to
+// users.
+struct PicariaRecord {
+    static const uint8_t Version = 1;
+    // Longer games are rejected as corrupt, which bounds a reader's memory.
+    static const size_t MaxMoves = 1 << 16;
+
+    enum Format {
+        BinaryFormat,
+        TextFormat
+    };
+
+    enum Result {
+        Unfinished,     // also a game stopped by the user
+        RedWin,
+        BlueWin,
+        Draw            // stopped by a move limit or agreement
+    };
+
+    enum Error {
+        NoError,
+        IllegalMove,    // a move the board does not allow, or one after the end
+        WrongResult     // the moves end the game another way
+    };
+
+    PicariaBoard::Mode mode = PicariaBoard::NineHoles;
+    Result result = Unfinished;
+    std::vector<PicariaMove> moves;
+
+    // Replays the moves with the rules of the user interface and checks
+    // the result against the end of the game. index is set to the first
+    // illegal move.
+    Error validate(size_t* index = nullptr) const;
+
+    std::string toText() const;
+    bool fromText(const std::string& line);
+
+    static std::string format(PicariaMove move);
+    static PicariaMove parse(const std::string& text);
+
+};
+
+// Writes games to a file, in either format.
+class PicariaRecordWriter {
+public:
+    PicariaRecordWriter();
+    ~PicariaRecordWriter();
+
+    PicariaRecordWriter(const PicariaRecordWriter&) = delete;
+    PicariaRecordWriter& operator=(const PicariaRecordWriter&) = delete;
+
+    bool open(const std::string& path, PicariaRecord::Format format);
+    bool write(const PicariaRecord& record);
+    // Flushes and closes; false if anything failed to be written.
+    bool close();
+
+private:
+    FILE* m_file;
+    PicariaRecord::Format m_format;
+    bool m_failed;
+    std::vector<uint8_t> m_bytes;
+
+};
+
+// Reads the games of a file one by one, in a single pass with a fixed
+// size buffer, so files of any length are read in bounded memory. The
+// format is recognized from the first bytes.
+class PicariaRecordReader {
+public:
+    PicariaRecordReader();
+    ~PicariaRecordReader();
+
+    PicariaRecordReader(const PicariaRecordReader&) = delete;
+    PicariaRecordReader& operator=(const PicariaRecordReader&) = delete;
+
+    bool open(const std::string& path);
+    PicariaRecord::Format format() const { return m_format; }
+
+    // The next game, reusing the memory of record. Returns false at the
+    // end of the file, or at data that does not parse; error() tells them
+    // apart.
+    bool read(PicariaRecord& record);
+    const std::string& error() const { return m_error; }
+    size_t count() const { return m_count; }
+
+private:
+    static const size_t BufferSize = 1 << 20;
+
+    FILE* m_file;
+    PicariaRecord::Format m_format;
+    std::vector<uint8_t> m_buffer;
+    size_t m_position;
+    size_t m_size;
+    size_t m_count;
+    std::string m_error;
+
+    bool fill(size_t bytes);
+    bool readBinary(PicariaRecord& record);
+    bool readText(PicariaRecord& record);
+    bool fail(const std::string& error);
+
+};
+
+#endif // PICARIARECORD_H
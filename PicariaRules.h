@@ -0,0 +1,181 @@
+#ifndef PICARIARULES_H
+#define PICARIARULES_H
+
+#include "PicariaBoard.h"
+
+#include <cstdint>
+
+// Board geometry of both modes as compile time data. Everything here is
+// indexed by PicariaBoard::Mode and hole id; bit n of a mask is hole n.
+namespace PicariaGeometry {
+
+constexpr uint16_t bits(int a, int b, int c = -1, int d = -1,
+                        int e = -1, int f = -1, int g = -1, int h = -1) {
+    return (1u << a) | (1u << b) |
+            (c < 0 ? 0 : 1u << c) | (d < 0 ? 0 : 1u << d) |
+            (e < 0 ? 0 : 1u << e) | (f < 0 ? 0 : 1u << f) |
+            (g < 0 ? 0 : 1u << g) | (h < 0 ? 0 : 1u << h);
+}
+
+// Holes 3, 4, 8 and 9 only exist on the thirteen holes board.
+inline constexpr uint16_t holes[2] = {
+    0x1fff & ~bits(3, 4, 8, 9),
+    0x1fff
+};
+
+// Holes reachable in one slide from each hole.
+inline constexpr uint16_t adjacency[2][PicariaBoard::HoleCount] = {
+    // NineHoles
+    {
+        bits(1, 5, 6),                      // 0
+        bits(0, 2, 5, 6, 7),                // 1
+        bits(1, 6, 7),                      // 2
+        0,                                  // 3
+        0,                                  // 4
+        bits(0, 1, 6, 10, 11),              // 5
+        bits(0, 1, 2, 5, 7, 10, 11, 12),    // 6
+        bits(1, 2, 6, 11, 12),              // 7
+        0,                                  // 8
+        0,                                  // 9
+        bits(5, 6, 11),                     // 10
+        bits(5, 6, 7, 10, 12),              // 11
+        bits(6, 7, 11)                      // 12
+    },
+    // ThirteenHoles
+    {
+        bits(1, 3, 5),                      // 0
+        bits(0, 2, 3, 4, 6),                // 1
+        bits(1, 4, 7),                      // 2
+        bits(0, 1, 5, 6),                   // 3
+        bits(1, 2, 6, 7),                   // 4
+        bits(0, 3, 6, 8, 10),               // 5
+        bits(1, 3, 4, 5, 7, 8, 9, 11),      // 6
+        bits(2, 4, 6, 9, 12),               // 7
+        bits(5, 6, 10, 11),                 // 8
+        bits(6, 7, 11, 12),                 // 9
+        bits(5, 8, 11),                     // 10
+        bits(6, 8, 9, 10, 12),              // 11
+        bits(7, 9, 11)                      // 12
+    }
+};
+
+// Three holes in a row. Only the first lineCount[mode] entries are used.
+inline constexpr int maxLines = 16;
+inline constexpr int lineCount[2] = { 8, 16 };
+inline constexpr uint16_t lines[2][maxLines] = {
+    // NineHoles
+    {
+        bits(0, 1, 2), bits(5, 6, 7), bits(10, 11, 12),         // rows
+        bits(0, 5, 10), bits(1, 6, 11), bits(2, 7, 12),         // cols
+        bits(0, 6, 12),                                         // diagonal
+        bits(2, 6, 10)                                          // anti-diagonal
+    },
+    // ThirteenHoles
+    {
+        bits(0, 1, 2), bits(5, 6, 7), bits(10, 11, 12),         // rows
+        bits(0, 5, 10), bits(1, 6, 11), bits(2, 7, 12),         // cols
+        bits(0, 3, 6), bits(3, 6, 9), bits(6, 9, 12),           // diagonals
+        bits(1, 4, 7), bits(5, 8, 11),
+        bits(2, 4, 6), bits(4, 6, 8), bits(6, 8, 10),           // anti-diagonals
+        bits(1, 3, 5), bits(7, 9, 11)
+    }
+};
+
+// Bit i is set when lines[mode][i] goes through hole id.
+constexpr uint16_t through(int mode, int id) {
+    uint16_t set = 0;
+    for (int i = 0; i < lineCount[mode]; ++i)
+        if (lines[mode][i] & (1u << id))
+            set |= 1u << i;
+    return set;
+}
+
+inline constexpr uint16_t linesThrough[2][PicariaBoard::HoleCount] = {
+    {
+        through(0, 0), through(0, 1), through(0, 2), through(0, 3), through(0, 4),
+        through(0, 5), through(0, 6), through(0, 7), through(0, 8), through(0, 9),
+        through(0, 10), through(0, 11), through(0, 12)
+    },
+    {
+        through(1, 0), through(1, 1), through(1, 2), through(1, 3), through(1, 4),
+        through(1, 5), through(1, 6), through(1, 7), through(1, 8), through(1, 9),
+        through(1, 10), through(1, 11), through(1, 12)
+    }
+};
+
+}
+
+// Rules engine specialized on the board mode. Every table lookup below is
+// resolved at compile time, so the loops unroll without mode branches.
+// Engines pick the specialization once with picariaDispatch().
+template <PicariaBoard::Mode M>
+class PicariaRules {
+public:
+    static constexpr PicariaBoard::Mode mode = M;
+    static constexpr uint16_t holes = PicariaGeometry::holes[M];
+    static constexpr int lineCount = PicariaGeometry::lineCount[M];
+
+    static constexpr uint16_t neighbours(int id) { return PicariaGeometry::adjacency[M][id]; }
+    static constexpr uint16_t line(int index) { return PicariaGeometry::lines[M][index]; }
+
+    static uint16_t destinations(uint16_t occupied, int id) {
+        return PicariaRules::neighbours(id) & ~occupied;
+    }
+
+    static bool hasLine(uint16_t pieces) {
+        bool found = false;
+        for (int i = 0; i < lineCount; ++i)
+            found |= (pieces & line(i)) == line(i);
+        return found;
+    }
+
+    static bool hasLineThrough(uint16_t pieces, int id) {
+        for (uint16_t set = PicariaGeometry::linesThrough[M][id]; set != 0; set &= set - 1) {
+            uint16_t mask = line(__builtin_ctz(set));
+            if ((pieces & mask) == mask)
+                return true;
+        }
+        return false;
+    }
+
+    // Holes the player could play to: every empty hole while dropping,
+    // otherwise every empty hole next to one of the player's pieces.
+    static uint16_t targets(uint16_t pieces, uint16_t occupied, PicariaBoard::Phase phase) {
+        if (phase == PicariaBoard::DropPhase)
+            return holes & ~occupied;
+
+        uint16_t reach = 0;
+        for (uint16_t set = pieces; set != 0; set &= set - 1)
+            reach |= PicariaRules::neighbours(__builtin_ctz(set));
+        return reach & ~occupied;
+    }
+
+    static void generate(const PicariaBoard& board, PicariaMoveList& list) {
+        uint16_t occupied = board.occupied();
+
+        if (board.phase() == PicariaBoard::DropPhase) {
+            for (uint16_t to = holes & ~occupied; to != 0; to &= to - 1)
+                list.append(PicariaMove::drop(__builtin_ctz(to)));
+            return;
+        }
+
+        for (uint16_t from = board.pieces(board.player()); from != 0; from &= from - 1) {
+            int id = __builtin_ctz(from);
+            for (uint16_t to = PicariaRules::destinations(occupied, id); to != 0; to &= to - 1)
+                list.append(PicariaMove::slide(id, __builtin_ctz(to)));
+        }
+    }
+
+};
+
+// Calls function with the rules of the given mode. This is the only place
+// engines branch on the mode; everything below it is specialized.
+template <typename Function>
+auto picariaDispatch(PicariaBoard::Mode mode, Function&& function) {
+    if (mode == PicariaBoard::NineHoles)
+        return function(PicariaRules<PicariaBoard::NineHoles>());
+    else
+        return function(PicariaRules<PicariaBoard::ThirteenHoles>());
+}
+
+#endif // PICARIARULES_H
@@ -0,0 +1,264 @@
+#include "PicariaSearch.h"
+#include "PicariaRules.h"
+#include "PicariaSymmetry.h"
+#include "PicariaZobrist.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+// History scores are halved before any of them passes this, far below
+// the int range, so long sessions cannot overflow them.
+const int maxHistory = 1 << 24;
+
+// Mate scores are stored relative to the node, not to the root.
+int toTable(int score, int ply) {
+    if (score > PicariaSearch::WinScore - PicariaSearch::MaxDepth)
+        return score + ply;
+    if (score < -PicariaSearch::WinScore + PicariaSearch::MaxDepth)
+        return score - ply;
+    return score;
+}
+
+int fromTable(int score, int ply) {
+    if (score > PicariaSearch::WinScore - PicariaSearch::MaxDepth)
+        return score - ply;
+    if (score < -PicariaSearch::WinScore + PicariaSearch::MaxDepth)
+        return score + ply;
+    return score;
+}
+
+}
+
+PicariaSearch::PicariaSearch(size_t tableBytes, int threads)
+    : m_table(tableBytes),
+      m_nodeLimit(0),
+      m_searched(0),
+      m_stop(false),
+      m_score(0),
+      m_depth(0) {
+    this->setThreads(threads);
+}
+
+void PicariaSearch::setThreads(int threads) {
+    if (threads <= 0)
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    m_threads.assign(threads > 0 ? threads : 1, Thread());
+    this->clear();
+}
+
+uint64_t PicariaSearch::nodes() const {
+    uint64_t nodes = 0;
+    for (const Thread& thread : m_threads)
+        nodes += thread.nodes;
+    return nodes;
+}
+
+PicariaMove PicariaSearch::think(const PicariaBoard& board, int milliseconds) {
+    return this->think(board, milliseconds, MaxDepth);
+}
+
+PicariaMove PicariaSearch::think(const PicariaBoard& board, int milliseconds, int maxDepth) {
+    Limits limits;
+    limits.softMilliseconds = std::max(milliseconds / 2, 1);
+    limits.hardMilliseconds = std::max(milliseconds, 1);
+    limits.depth = maxDepth;
+    return this->think(board, limits);
+}
+
+PicariaMove PicariaSearch::think(const PicariaBoard& board, const Limits& limits) {
+    Clock::time_point now = Clock::now();
+    m_softDeadline = limits.softMilliseconds > 0 ? now + std::chrono::milliseconds(limits.softMilliseconds)
+                                                 : Clock::time_point::max();
+    // The hard limit keeps a tenth of the budget, up to a millisecond,
+    // for unwinding the search and joining the helpers.
+    std::chrono::microseconds budget(static_cast<int64_t>(limits.hardMilliseconds) * 1000);
+    m_deadline = limits.hardMilliseconds > 0 ? now + budget - std::min(budget / 10, std::chrono::microseconds(1000))
+                                             : Clock::time_point::max();
+    m_nodeLimit = limits.nodes > 0 ? limits.nodes : UINT64_MAX;
+    int maxDepth = std::max(std::min(limits.depth, static_cast<int>(MaxDepth)), 1);
+
+    return picariaDispatch(board.mode(), [this, &board, maxDepth](auto rules) {
+        return this->iterate<decltype(rules)>(board, maxDepth);
+    });
+}
+
+void PicariaSearch::clear() {
+    m_table.clear();
+    for (Thread& thread : m_threads)
+        std::memset(&thread, 0, sizeof(thread));
+}
+
+template <typename Rules>
+PicariaMove PicariaSearch::iterate(const PicariaBoard& board, int maxDepth) {
+    // Older searches count for less in the move ordering.
+    for (Thread& thread : m_threads) {
+        thread.nodes = 0;
+        PicariaSearch::age(thread);
+    }
+    m_searched = 0;
+    m_stop = false;
+    m_score = 0;
+    m_depth = 0;
+    m_table.age();
+
+    PicariaMoveList list;
+    Rules::generate(board, list);
+    if (list.count == 0)
+        return PicariaMove();
+
+    // Helpers start one ply deeper every other thread so that they fill
+    // the table ahead of the main thread instead of repeating its work.
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < m_threads.size(); ++i) {
+        helpers.emplace_back([this, root = board, maxDepth, i]() mutable {
+            Thread& thread = m_threads[i];
+            for (int depth = 1 + static_cast<int>(i & 1); depth <= maxDepth && !m_stop; ++depth)
+                this->search<Rules>(thread, root, depth, -WinScore, WinScore, 0, nullptr);
+        });
+    }
+
+    // Every thread makes and unmakes moves on its own copy of the root.
+    PicariaBoard root = board;
+    PicariaMove best = list[0];
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        PicariaMove move;
+        int score = this->search<Rules>(m_threads[0], root, depth, -WinScore, WinScore, 0, &move);
+        if (m_stop)
+            break;
+
+        best = move;
+        m_score = score;
+        m_depth = depth;
+
+        // A forced result does not change with more depth.
+        if (std::abs(score) > WinScore - MaxDepth || Clock::now() >= m_softDeadline)
+            break;
+    }
+
+    m_stop = true;
+    for (std::thread& helper : helpers)
+        helper.join();
+
+    return best;
+}
+
+template <typename Rules>
+int PicariaSearch::search(Thread& thread, PicariaBoard& board, int depth, int alpha, int beta, int ply, PicariaMove* best) {
+    if ((++thread.nodes & 255) == 0) {
+        uint64_t searched = m_searched.fetch_add(256, std::memory_order_relaxed) + 256;
+        if (this->isStopped() || searched >= m_nodeLimit || Clock::now() >= m_deadline)
+            m_stop = true;
+    }
+    if (m_stop.load(std::memory_order_relaxed))
+        return 0;
+
+    PicariaMoveList list;
+    Rules::generate(board, list);
+    if (list.count == 0)
+        return -(WinScore - ply);
+    if (depth <= 0)
+        return PicariaSearch::evaluate<Rules>(board);
+
+    // Symmetric positions share their table entry: the key is the one of
+    // the canonical representative, and so is the stored move.
+    const int symmetry = PicariaSymmetry::canonical(board);
+    const uint64_t key = PicariaZobrist::key(PicariaSymmetry::board(symmetry, board));
+
+    PicariaMove first;
+    PicariaTranspositionTable::Entry entry;
+    if (m_table.probe(key, entry)) {
+        first = PicariaSymmetry::move(PicariaSymmetry::inverse(symmetry), entry.move);
+        if (entry.depth >= depth && ply > 0) {
+            int score = fromTable(entry.score, ply);
+            if (entry.bound == PicariaTranspositionTable::ExactBound ||
+                    (entry.bound == PicariaTranspositionTable::LowerBound && score >= beta) ||
+                    (entry.bound == PicariaTranspositionTable::UpperBound && score <= alpha))
+                return score;
+        }
+    }
+    PicariaSearch::order(thread, board, list, first);
+
+    const PicariaBoard::Player player = board.player();
+    const int start = alpha;
+    int bestScore = -WinScore;
+    PicariaMove bestMove;
+
+    for (PicariaMove move : list) {
+        board.play(move);
+        int score;
+        if (Rules::hasLineThrough(board.pieces(player), move.to))
+            score = WinScore - ply - 1;
+        else
+            score = -this->search<Rules>(thread, board, depth - 1, -beta, -alpha, ply + 1, nullptr);
+        board.undo(move);
+
+        if (m_stop.load(std::memory_order_relaxed))
+            return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+        }
+        if (score > alpha)
+            alpha = score;
+        if (alpha >= beta) {
+            int& history = thread.history[player][move.from + 1][move.to];
+            history += depth * depth;
+            if (history > maxHistory)
+                PicariaSearch::age(thread);
+            break;
+        }
+    }
+
+    PicariaTranspositionTable::Bound bound = bestScore <= start ? PicariaTranspositionTable::UpperBound :
+                                             bestScore >= beta ? PicariaTranspositionTable::LowerBound :
+                                                                 PicariaTranspositionTable::ExactBound;
+    m_table.store(key, toTable(bestScore, ply), depth, bound, PicariaSymmetry::move(symmetry, bestMove));
+
+    if (best != nullptr)
+        *best = bestMove;
+    return bestScore;
+}
+
+// Open twos (two pieces of a line whose third hole is empty) and the
+// number of holes each side can reach, from the side to move.
+template <typename Rules>
+int PicariaSearch::evaluate(const PicariaBoard& board) {
+    const PicariaBoard::Player player = board.player();
+    const uint16_t own = board.pieces(player);
+    const uint16_t other = board.pieces(PicariaBoard::opponent(player));
+    const uint16_t occupied = own | other;
+
+    int score = 0;
+    for (int i = 0; i < Rules::lineCount; ++i) {
+        uint16_t line = Rules::line(i);
+        if (!(other & line) && __builtin_popcount(own & line) == 2)
+            score += 30;
+        else if (!(own & line) && __builtin_popcount(other & line) == 2)
+            score -= 30;
+    }
+
+    score += __builtin_popcount(Rules::targets(own, occupied, board.phase()));
+    score -= __builtin_popcount(Rules::targets(other, occupied, board.phase()));
+
+    return score;
+}
+
+void PicariaSearch::age(Thread& thread) {
+    for (auto& player : thread.history)
+        for (auto& from : player)
+            for (int& score : from)
+                score /= 2;
+}
+
+void PicariaSearch::order(const Thread& thread, const PicariaBoard& board, PicariaMoveList& list, PicariaMove first) {
+    const int (*history)[PicariaBoard::HoleCount] = thread.history[board.player()];
+    std::stable_sort(list.moves, list.moves + list.count, [&](PicariaMove a, PicariaMove b) {
+        if (a == first || b == first)
+            return a == first && b != first;
+        return history[a.from + 1][a.to] > history[b.from + 1][b.to];
+    });
+}
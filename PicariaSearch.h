@@ -0,0 +1,90 @@
+#ifndef PICARIASEARCH_H
+#define PICARIASEARCH_H
+
+#include "PicariaBoard.h"
+#include "PicariaEngine.h"
+#include "PicariaTranspositionTable.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Iterative deepening alpha-beta search. Scores are from the side to move:
+// WinScore - n is a win in n plies, -(WinScore - n) a loss in n plies.
+// Each search owns its transposition table, bounded by tableBytes; the
+// eight symmetric images of a position share one entry.
+//
+// With more than one thread the search is a lazy SMP: helper threads
+// search the same root, staggered in depth, and only talk to the main
+// thread through the lock-free transposition table they share.
+//
+// The search returns the best move of the last iteration it completed.
+// It ends at the hard time limit, the node limit or stop(), even in the
+// middle of an iteration, and starts no new iteration after the soft
+// time limit: one that starts that late rarely completes in time.
+class PicariaSearch : public PicariaEngine {
+public:
+    static const int WinScore = 10000;
+    static const int MaxDepth = 64;
+
+    // Zero means no limit. Limits are checked every 256 nodes of each
+    // thread, and the search stops short of the hard limit to leave time
+    // to return: think() returns within it.
+    struct Limits {
+        int softMilliseconds = 0;
+        int hardMilliseconds = 0;
+        uint64_t nodes = 0;
+        int depth = MaxDepth;
+    };
+
+    // threads <= 0 uses one thread per core.
+    explicit PicariaSearch(size_t tableBytes = 4 << 20, int threads = 1);
+
+    // milliseconds is the hard limit; the soft limit is half of it.
+    PicariaMove think(const PicariaBoard& board, int milliseconds) override;
+    PicariaMove think(const PicariaBoard& board, int milliseconds, int maxDepth);
+    PicariaMove think(const PicariaBoard& board, const Limits& limits);
+
+    int threads() const { return static_cast<int>(m_threads.size()); }
+    void setThreads(int threads);
+
+    int score() const { return m_score; }
+    int depth() const { return m_depth; }
+    uint64_t nodes() const;
+
+    PicariaTranspositionTable& table() { return m_table; }
+    void clear() override;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Thread {
+        int history[2][PicariaBoard::HoleCount + 1][PicariaBoard::HoleCount];
+        uint64_t nodes;
+    };
+
+    PicariaTranspositionTable m_table;
+    std::vector<Thread> m_threads;
+    Clock::time_point m_softDeadline;
+    Clock::time_point m_deadline;
+    uint64_t m_nodeLimit;
+    std::atomic<uint64_t> m_searched;
+    std::atomic<bool> m_stop;
+    int m_score;
+    int m_depth;
+
+    template <typename Rules>
+    PicariaMove iterate(const PicariaBoard& board, int maxDepth);
+    template <typename Rules>
+    int search(Thread& thread, PicariaBoard& board, int depth, int alpha, int beta, int ply, PicariaMove* best);
+    template <typename Rules>
+    static int evaluate(const PicariaBoard& board);
+
+    static void age(Thread& thread);
+    static void order(const Thread& thread, const PicariaBoard& board, PicariaMoveList& list, PicariaMove first);
+
+};
+
+#endif // PICARIASEARCH_H
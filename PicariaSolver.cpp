@@ -0,0 +1,161 @@
+#include "PicariaSolver.h"
+#include "PicariaRules.h"
+#include "PicariaTablebase.h"
+
+#include <algorithm>
+#include <cassert>
+
+PicariaSolver::PicariaSolver(PicariaBoard::Mode mode)
+    : m_mode(mode),
+      m_rounds(0) {
+}
+
+void PicariaSolver::solve() {
+    picariaDispatch(m_mode, [this](auto rules) {
+        this->solve(rules);
+    });
+}
+
+size_t PicariaSolver::count(int result) const {
+    return std::count_if(m_entries.begin(), m_entries.end(), [result](uint8_t entry) {
+        return PicariaTablebase::decodeResult(entry) == result;
+    });
+}
+
+template <typename Rules>
+void PicariaSolver::solve(Rules rules) {
+    const PicariaBoard::Mode mode = Rules::mode;
+    const size_t size = PicariaTablebase::size(mode);
+    const uint8_t unknown = PicariaTablebase::encode(PicariaTablebase::UnknownResult, 0);
+    const uint8_t lost = PicariaTablebase::encode(PicariaTablebase::LossResult, 0);
+
+    m_entries.assign(size, unknown);
+    m_rounds = 0;
+
+    // Calls visit with the index of every position reachable in one move.
+    auto forEachChild = [mode](uint16_t pieces[2], PicariaBoard::Player player, PicariaBoard::Phase phase, auto visit) {
+        PicariaBoard::Player opponent = PicariaBoard::opponent(player);
+        uint16_t own = pieces[player];
+        uint16_t occupied = pieces[0] | pieces[1];
+        uint16_t child[2];
+        child[opponent] = pieces[opponent];
+
+        if (phase == PicariaBoard::DropPhase) {
+            for (uint16_t to = Rules::holes & ~occupied; to != 0; to &= to - 1) {
+                child[player] = own | (to & -to);
+                visit(PicariaTablebase::index(mode, child[0], child[1], opponent));
+            }
+            return;
+        }
+
+        for (uint16_t from = own; from != 0; from &= from - 1) {
+            int id = __builtin_ctz(from);
+            for (uint16_t to = Rules::destinations(occupied, id); to != 0; to &= to - 1) {
+                child[player] = (own & ~(1u << id)) | (to & -to);
+                visit(PicariaTablebase::index(mode, child[0], child[1], opponent));
+            }
+        }
+    };
+
+    // Classify every position: invalid, already decided, or still open.
+    // Every index is a canonical representative; index() maps every child
+    // to one.
+    std::vector<uint32_t> open;
+    std::vector<uint32_t> drops[PicariaBoard::MaxDrops];
+    for (size_t index = 0; index < size; ++index) {
+        PicariaBoard board = PicariaTablebase::board(mode, index);
+        PicariaBoard::Player player = board.player();
+        PicariaBoard::Player opponent = PicariaBoard::opponent(player);
+
+        // Piece counts always fit the side to move; a line of the side to
+        // move is what makes a position invalid.
+        if (rules.hasLine(board.pieces(player)))
+            continue;
+
+        if (rules.hasLine(board.pieces(opponent)))
+            m_entries[index] = lost;
+        else if (board.phase() == PicariaBoard::DropPhase)
+            drops[__builtin_popcount(board.occupied())].push_back(static_cast<uint32_t>(index));
+        else if (rules.targets(board.pieces(player), board.occupied(), PicariaBoard::MovePhase) == 0)
+            m_entries[index] = lost;
+        else
+            open.push_back(static_cast<uint32_t>(index));
+    }
+
+    // Move phase: the graph has cycles, so solve it backwards by rounds.
+    // Round d labels the wins in d plies (a move to a loss in d - 1) and
+    // the losses in d plies (every move goes to a win in at most d - 1).
+    std::vector<std::pair<uint32_t, uint8_t>> decided;
+    for (int d = 1; !open.empty(); ++d) {
+        assert(d <= PicariaTablebase::MaxDistance);
+        decided.clear();
+
+        size_t kept = 0;
+        for (uint32_t index : open) {
+            PicariaBoard board = PicariaTablebase::board(mode, index);
+            uint16_t pieces[2] = { board.pieces(PicariaBoard::RedPlayer), board.pieces(PicariaBoard::BluePlayer) };
+            bool win = false;
+            bool allWins = true;
+
+            forEachChild(pieces, board.player(), PicariaBoard::MovePhase, [&](size_t child) {
+                uint8_t entry = m_entries[child];
+                PicariaTablebase::Result result = PicariaTablebase::decodeResult(entry);
+                int distance = PicariaTablebase::decodeDistance(entry);
+                if (result == PicariaTablebase::LossResult && distance == d - 1)
+                    win = true;
+                if (result != PicariaTablebase::WinResult || distance >= d)
+                    allWins = false;
+            });
+
+            if (win)
+                decided.emplace_back(index, PicariaTablebase::encode(PicariaTablebase::WinResult, d));
+            else if (allWins)
+                decided.emplace_back(index, PicariaTablebase::encode(PicariaTablebase::LossResult, d));
+            else
+                open[kept++] = index;
+        }
+        open.resize(kept);
+
+        for (const auto& entry : decided)
+            m_entries[entry.first] = entry.second;
+
+        m_rounds = d;
+        if (decided.empty())
+            break;
+    }
+
+    // Whatever is still open can be kept away from a decision forever.
+    for (uint32_t index : open)
+        m_entries[index] = PicariaTablebase::encode(PicariaTablebase::DrawResult, 0);
+
+    // Drop phase: every drop adds a piece, so solve it from the last drop
+    // backwards; the children of the last drop are move phase positions.
+    for (int pieceCount = PicariaBoard::MaxDrops - 1; pieceCount >= 0; --pieceCount) {
+        for (uint32_t index : drops[pieceCount]) {
+            PicariaBoard board = PicariaTablebase::board(mode, index);
+            uint16_t pieces[2] = { board.pieces(PicariaBoard::RedPlayer), board.pieces(PicariaBoard::BluePlayer) };
+            int fastestWin = -1;
+            int slowestLoss = -1;
+            bool allWins = true;
+
+            forEachChild(pieces, board.player(), PicariaBoard::DropPhase, [&](size_t child) {
+                uint8_t entry = m_entries[child];
+                PicariaTablebase::Result result = PicariaTablebase::decodeResult(entry);
+                int distance = PicariaTablebase::decodeDistance(entry);
+                if (result == PicariaTablebase::LossResult && (fastestWin < 0 || distance + 1 < fastestWin))
+                    fastestWin = distance + 1;
+                if (result == PicariaTablebase::WinResult)
+                    slowestLoss = std::max(slowestLoss, distance + 1);
+                else
+                    allWins = false;
+            });
+
+            if (fastestWin >= 0)
+                m_entries[index] = PicariaTablebase::encode(PicariaTablebase::WinResult, fastestWin);
+            else if (allWins)
+                m_entries[index] = PicariaTablebase::encode(PicariaTablebase::LossResult, slowestLoss);
+            else
+                m_entries[index] = PicariaTablebase::encode(PicariaTablebase::DrawResult, 0);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef PICARIASOLVER_H
+#define PICARIASOLVER_H
+
+#include "PicariaBoard.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Retrograde analysis of one board mode. Every valid position is labelled
+// as a win, loss or draw for the side to move, with the number of plies
+// to the end of the game under perfect play (fastest win, slowest loss).
+//
+// A position is lost when the opponent has three in a row, or when the
+// side to move has no legal slide. Positions that cannot occur in a game,
+// such as the side to move already owning a line, stay UnknownResult.
+// Symmetric positions are solved once, through their canonical
+// representative (see PicariaSymmetry).
+class PicariaSolver {
+public:
+    explicit PicariaSolver(PicariaBoard::Mode mode);
+
+    PicariaBoard::Mode mode() const { return m_mode; }
+
+    void solve();
+
+    // PicariaTablebase entries, indexed by PicariaTablebase::index().
+    const std::vector<uint8_t>& entries() const { return m_entries; }
+    std::vector<uint8_t> takeEntries() { return std::move(m_entries); }
+
+    int rounds() const { return m_rounds; }
+    size_t count(int result) const;
+
+private:
+    PicariaBoard::Mode m_mode;
+    std::vector<uint8_t> m_entries;
+    int m_rounds;
+
+    template <typename Rules>
+    void solve(Rules rules);
+
+};
+
+#endif // PICARIASOLVER_H
@@ -0,0 +1,93 @@
+#include "PicariaSymmetry.h"
+
+namespace {
+
+// Column and row of every hole on the five by five grid of the board.
+const int squares[PicariaBoard::HoleCount][2] = {
+    { 0, 0 }, { 2, 0 }, { 4, 0 },
+    { 1, 1 }, { 3, 1 },
+    { 0, 2 }, { 2, 2 }, { 4, 2 },
+    { 1, 3 }, { 3, 3 },
+    { 0, 4 }, { 2, 4 }, { 4, 4 }
+};
+
+// Image of square (x, y): the identity, the three rotations, then the
+// reflections in the vertical and horizontal axes and the two diagonals.
+void transform(int symmetry, int x, int y, int& tx, int& ty) {
+    switch (symmetry) {
+        case 0: tx = x;     ty = y;     break;
+        case 1: tx = 4 - y; ty = x;     break;
+        case 2: tx = 4 - x; ty = 4 - y; break;
+        case 3: tx = y;     ty = 4 - x; break;
+        case 4: tx = 4 - x; ty = y;     break;
+        case 5: tx = x;     ty = 4 - y; break;
+        case 6: tx = y;     ty = x;     break;
+        default: tx = 4 - y; ty = 4 - x; break;
+    }
+}
+
+}
+
+PicariaSymmetry::Tables::Tables() {
+    for (int s = 0; s < Count; ++s) {
+        for (int id = 0; id < PicariaBoard::HoleCount; ++id) {
+            int x;
+            int y;
+            transform(s, squares[id][0], squares[id][1], x, y);
+            for (int image = 0; image < PicariaBoard::HoleCount; ++image)
+                if (squares[image][0] == x && squares[image][1] == y)
+                    holes[s][id] = static_cast<int8_t>(image);
+        }
+
+        for (int mask = 0; mask < (1 << 7); ++mask) {
+            low[s][mask] = 0;
+            for (int id = 0; id < 7; ++id)
+                if (mask & (1 << id))
+                    low[s][mask] |= 1u << holes[s][id];
+        }
+        for (int mask = 0; mask < (1 << (PicariaBoard::HoleCount - 7)); ++mask) {
+            high[s][mask] = 0;
+            for (int id = 7; id < PicariaBoard::HoleCount; ++id)
+                if (mask & (1 << (id - 7)))
+                    high[s][mask] |= 1u << holes[s][id];
+        }
+    }
+
+    for (int s = 0; s < Count; ++s)
+        for (int t = 0; t < Count; ++t)
+            if (holes[t][holes[s][0]] == 0 && holes[t][holes[s][1]] == 1)
+                inverse[s] = static_cast<int8_t>(t);
+}
+
+const PicariaSymmetry::Tables& PicariaSymmetry::tables() {
+    static const Tables instance;
+    return instance;
+}
+
+PicariaMove PicariaSymmetry::move(int symmetry, PicariaMove move) {
+    if (move.isNull())
+        return move;
+    if (move.isDrop())
+        return PicariaMove::drop(PicariaSymmetry::hole(symmetry, move.to));
+    return PicariaMove::slide(PicariaSymmetry::hole(symmetry, move.from), PicariaSymmetry::hole(symmetry, move.to));
+}
+
+PicariaBoard PicariaSymmetry::board(int symmetry, const PicariaBoard& board) {
+    return PicariaBoard(board.mode(),
+                        PicariaSymmetry::mask(symmetry, board.pieces(PicariaBoard::RedPlayer)),
+                        PicariaSymmetry::mask(symmetry, board.pieces(PicariaBoard::BluePlayer)),
+                        board.player());
+}
+
+int PicariaSymmetry::canonical(uint16_t red, uint16_t blue) {
+    int best = 0;
+    uint32_t smallest = static_cast<uint32_t>(red) << 16 | blue;
+    for (int s = 1; s < Count; ++s) {
+        uint32_t image = static_cast<uint32_t>(PicariaSymmetry::mask(s, red)) << 16 | PicariaSymmetry::mask(s, blue);
+        if (image < smallest) {
+            smallest = image;
+            best = s;
+        }
+    }
+    return best;
+}
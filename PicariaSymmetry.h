@@ -0,0 +1,52 @@
+#ifndef PICARIASYMMETRY_H
+#define PICARIASYMMETRY_H
+
+#include "PicariaBoard.h"
+
+#include <cstdint>
+
+// The eight rotations and reflections of the square. Both boards are
+// invariant under them, holes, neighbours and lines alike, so symmetric
+// positions have the same value and engines can store one of them only.
+// Symmetry 0 is the identity.
+class PicariaSymmetry {
+public:
+    static const int Count = 8;
+
+    static int hole(int symmetry, int id) { return PicariaSymmetry::tables().holes[symmetry][id]; }
+    static int inverse(int symmetry) { return PicariaSymmetry::tables().inverse[symmetry]; }
+
+    static uint16_t mask(int symmetry, uint16_t mask) {
+        const Tables& t = PicariaSymmetry::tables();
+        return t.low[symmetry][mask & 0x7f] | t.high[symmetry][mask >> 7];
+    }
+
+    static PicariaMove move(int symmetry, PicariaMove move);
+    static PicariaBoard board(int symmetry, const PicariaBoard& board);
+
+    // The symmetry that takes a position to its canonical representative:
+    // the image with the smallest red, then blue, pieces.
+    static int canonical(uint16_t red, uint16_t blue);
+    static int canonical(const PicariaBoard& board) {
+        return PicariaSymmetry::canonical(board.pieces(PicariaBoard::RedPlayer), board.pieces(PicariaBoard::BluePlayer));
+    }
+    static PicariaBoard canonicalBoard(const PicariaBoard& board) {
+        return PicariaSymmetry::board(PicariaSymmetry::canonical(board), board);
+    }
+
+private:
+    // A mask is mapped seven and six holes at a time.
+    struct Tables {
+        int8_t holes[Count][PicariaBoard::HoleCount];
+        int8_t inverse[Count];
+        uint16_t low[Count][1 << 7];
+        uint16_t high[Count][1 << (PicariaBoard::HoleCount - 7)];
+
+        Tables();
+    };
+
+    static const Tables& tables();
+
+};
+
+#endif // PICARIASYMMETRY_H
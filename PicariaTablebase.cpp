@@ -0,0 +1,149 @@
+#include "PicariaTablebase.h"
+#include "PicariaDataFile.h"
+#include "PicariaIndex.h"
+#include "PicariaSymmetry.h"
+
+#include <algorithm>
+#include <utility>
+
+PicariaTablebase::PicariaTablebase()
+    : m_entries{nullptr, nullptr} {
+}
+
+PicariaTablebase::~PicariaTablebase() {
+}
+
+PicariaTablebase::Result PicariaTablebase::result(const PicariaBoard& board) const {
+    const uint8_t* entries = m_entries[board.mode()];
+    return entries == nullptr ? PicariaTablebase::UnknownResult :
+                                PicariaTablebase::decodeResult(entries[PicariaTablebase::index(board)]);
+}
+
+int PicariaTablebase::distance(const PicariaBoard& board) const {
+    const uint8_t* entries = m_entries[board.mode()];
+    return entries == nullptr ? 0 : PicariaTablebase::decodeDistance(entries[PicariaTablebase::index(board)]);
+}
+
+PicariaMove PicariaTablebase::bestMove(const PicariaBoard& board) const {
+    if (this->isEmpty(board.mode()) || this->result(board) == PicariaTablebase::UnknownResult)
+        return PicariaMove();
+
+    // Ranks children from the mover's side: wins first, fastest first,
+    // then draws, then losses, slowest first.
+    PicariaMove best;
+    int bestRank = 0;
+    for (PicariaMove move : board.moves()) {
+        PicariaBoard child = board;
+        child.play(move);
+
+        int rank;
+        if (child.hasLineThrough(board.player(), move.to))
+            rank = 3 * 64;
+        else {
+            uint8_t entry = m_entries[board.mode()][PicariaTablebase::index(child)];
+            int distance = PicariaTablebase::decodeDistance(entry);
+            switch (PicariaTablebase::decodeResult(entry)) {
+                case PicariaTablebase::LossResult:
+                    rank = 3 * 64 - 1 - distance;
+                    break;
+                case PicariaTablebase::DrawResult:
+                    rank = 2 * 64;
+                    break;
+                case PicariaTablebase::WinResult:
+                    rank = 64 + distance;
+                    break;
+                default:
+                    return PicariaMove();
+            }
+        }
+        if (best.isNull() || rank > bestRank) {
+            best = move;
+            bestRank = rank;
+        }
+    }
+    return best;
+}
+
+void PicariaTablebase::setEntries(PicariaBoard::Mode mode, std::vector<uint8_t> entries) {
+    m_owned[mode] = std::move(entries);
+    m_entries[mode] = m_owned[mode].empty() ? nullptr : m_owned[mode].data();
+}
+
+bool PicariaTablebase::load(const std::string& path) {
+    return this->load(PicariaDataFile::open(path));
+}
+
+bool PicariaTablebase::load(std::shared_ptr<const PicariaDataFile> file) {
+    if (!file)
+        return false;
+
+    const void* sections[2];
+    for (int mode = 0; mode < 2; ++mode) {
+        size_t count = 0;
+        sections[mode] = file->section(PicariaDataFile::TablebaseSection, static_cast<PicariaBoard::Mode>(mode), count);
+        if (sections[mode] != nullptr && count != PicariaTablebase::size(static_cast<PicariaBoard::Mode>(mode)))
+            return false;
+    }
+    if (sections[0] == nullptr && sections[1] == nullptr)
+        return false;
+
+    for (int mode = 0; mode < 2; ++mode) {
+        m_owned[mode].clear();
+        m_entries[mode] = static_cast<const uint8_t*>(sections[mode]);
+    }
+    m_file = std::move(file);
+    return true;
+}
+
+size_t PicariaTablebase::size(PicariaBoard::Mode mode) {
+    return PicariaTablebase::tables().size[mode];
+}
+
+size_t PicariaTablebase::index(const PicariaBoard& board) {
+    return PicariaTablebase::index(board.mode(), board.pieces(PicariaBoard::RedPlayer),
+                                   board.pieces(PicariaBoard::BluePlayer), board.player());
+}
+
+size_t PicariaTablebase::index(PicariaBoard::Mode mode, uint16_t red, uint16_t blue, PicariaBoard::Player player) {
+    const Tables& t = PicariaTablebase::tables();
+    int symmetry = PicariaSymmetry::canonical(red, blue);
+    size_t rank = PicariaIndex::rank(mode, PicariaSymmetry::mask(symmetry, red), PicariaSymmetry::mask(symmetry, blue), player);
+    uint64_t below = t.canonical[mode][rank / 64] & ((uint64_t(1) << (rank % 64)) - 1);
+    return t.before[mode][rank / 64] + static_cast<size_t>(__builtin_popcountll(below));
+}
+
+PicariaBoard PicariaTablebase::board(PicariaBoard::Mode mode, size_t index) {
+    const Tables& t = PicariaTablebase::tables();
+    const std::vector<uint32_t>& before = t.before[mode];
+    size_t word = std::upper_bound(before.begin(), before.end(), static_cast<uint32_t>(index)) - before.begin() - 1;
+
+    uint64_t bits = t.canonical[mode][word];
+    for (size_t skip = index - before[word]; skip > 0; --skip)
+        bits &= bits - 1;
+    return PicariaIndex::board(mode, word * 64 + static_cast<size_t>(__builtin_ctzll(bits)));
+}
+
+PicariaTablebase::Tables::Tables() {
+    for (int mode = 0; mode < 2; ++mode) {
+        PicariaBoard::Mode m = static_cast<PicariaBoard::Mode>(mode);
+        size_t ranks = PicariaIndex::size(m);
+        canonical[mode].assign((ranks + 63) / 64, 0);
+        for (size_t rank = 0; rank < ranks; ++rank) {
+            PicariaBoard board = PicariaIndex::board(m, rank);
+            if (PicariaSymmetry::canonicalBoard(board) == board)
+                canonical[mode][rank / 64] |= uint64_t(1) << (rank % 64);
+        }
+
+        size_t count = 0;
+        for (uint64_t bits : canonical[mode]) {
+            before[mode].push_back(static_cast<uint32_t>(count));
+            count += static_cast<size_t>(__builtin_popcountll(bits));
+        }
+        size[mode] = count;
+    }
+}
+
+const PicariaTablebase::Tables& PicariaTablebase::tables() {
+    static const Tables instance;
+    return instance;
+}
@@ -0,0 +1,86 @@
+#ifndef PICARIATABLEBASE_H
+#define PICARIATABLEBASE_H
+
+#include "PicariaBoard.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class PicariaDataFile;
+
+// Game theoretic value of every position of both modes, from the point of
+// view of the side to move. Each entry is one byte: the result in the two
+// high bits and the distance to the end of the game, in plies, below.
+// Entries are either owned, as set by the solver, or read in place from a
+// mapped PicariaDataFile.
+class PicariaTablebase {
+public:
+    enum Result {
+        UnknownResult,
+        WinResult,
+        LossResult,
+        DrawResult
+    };
+
+    static const int MaxDistance = 63;
+
+    PicariaTablebase();
+    ~PicariaTablebase();
+
+    PicariaTablebase(const PicariaTablebase&) = delete;
+    PicariaTablebase& operator=(const PicariaTablebase&) = delete;
+
+    bool isEmpty(PicariaBoard::Mode mode) const { return m_entries[mode] == nullptr; }
+
+    Result result(const PicariaBoard& board) const;
+    int distance(const PicariaBoard& board) const;
+
+    // The move to the best child: the fastest win, else a draw, else the
+    // slowest loss. A null move when the position is not in the table.
+    PicariaMove bestMove(const PicariaBoard& board) const;
+
+    // size(mode) bytes, or null when the mode is empty.
+    const uint8_t* data(PicariaBoard::Mode mode) const { return m_entries[mode]; }
+    void setEntries(PicariaBoard::Mode mode, std::vector<uint8_t> entries);
+
+    // Uses the tablebase sections of a data file, for the modes it has.
+    bool load(const std::string& path);
+    bool load(std::shared_ptr<const PicariaDataFile> file);
+
+    // Positions are numbered densely by symmetry class: symmetric positions
+    // share the number of their canonical representative, and the
+    // representatives are numbered in PicariaIndex order. The phase and
+    // drop count are implied by the number of pieces.
+    static size_t size(PicariaBoard::Mode mode);
+    static size_t index(const PicariaBoard& board);
+    static size_t index(PicariaBoard::Mode mode, uint16_t red, uint16_t blue, PicariaBoard::Player player);
+    static PicariaBoard board(PicariaBoard::Mode mode, size_t index);
+
+    static uint8_t encode(Result result, int distance) { return static_cast<uint8_t>(result << 6 | distance); }
+    static Result decodeResult(uint8_t entry) { return static_cast<Result>(entry >> 6); }
+    static int decodeDistance(uint8_t entry) { return entry & MaxDistance; }
+
+private:
+    // Which PicariaIndex ranks are canonical, as a bitmap, and how many
+    // are before each word of it: a class number is one popcount away
+    // from a rank.
+    struct Tables {
+        std::vector<uint64_t> canonical[2];
+        std::vector<uint32_t> before[2];
+        size_t size[2];
+
+        Tables();
+    };
+
+    static const Tables& tables();
+
+    std::vector<uint8_t> m_owned[2];
+    const uint8_t* m_entries[2];
+    std::shared_ptr<const PicariaDataFile> m_file;
+
+};
+
+#endif // PICARIATABLEBASE_H
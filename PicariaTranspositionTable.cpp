@@ -0,0 +1,67 @@
+#include "PicariaTranspositionTable.h"
+
+PicariaTranspositionTable::PicariaTranspositionTable(size_t bytes)
+    : m_mask(0),
+      m_generation(0) {
+    // Round down to a power of two so that the index is a mask.
+    size_t count = 1;
+    while (count * 2 * sizeof(Slot) <= bytes)
+        count *= 2;
+
+    m_slots.reset(new Slot[count]);
+    m_mask = count - 1;
+    this->clear();
+}
+
+bool PicariaTranspositionTable::probe(uint64_t key, Entry& entry) const {
+    const Slot& slot = m_slots[key & m_mask];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != key)
+        return false;
+
+    entry = PicariaTranspositionTable::unpack(data);
+    return entry.bound != PicariaTranspositionTable::NoBound;
+}
+
+void PicariaTranspositionTable::store(uint64_t key, int score, int depth, Bound bound, PicariaMove move) {
+    Slot& slot = m_slots[key & m_mask];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    bool same = (slot.check.load(std::memory_order_relaxed) ^ data) == key;
+    Entry old = PicariaTranspositionTable::unpack(data);
+
+    if (same || old.generation != m_generation || depth >= old.depth) {
+        // Keep the best move of a shallower search of the same position.
+        if (move.isNull() && same)
+            move = old.move;
+
+        Entry entry{ static_cast<int16_t>(score), static_cast<int8_t>(depth),
+                     static_cast<uint8_t>(bound), m_generation, move };
+        data = PicariaTranspositionTable::pack(entry);
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
+    }
+}
+
+void PicariaTranspositionTable::clear() {
+    for (size_t i = 0; i <= m_mask; ++i) {
+        m_slots[i].check.store(0, std::memory_order_relaxed);
+        m_slots[i].data.store(0, std::memory_order_relaxed);
+    }
+    m_generation = 0;
+}
+
+uint64_t PicariaTranspositionTable::pack(const Entry& entry) {
+    return static_cast<uint64_t>(static_cast<uint16_t>(entry.score)) |
+            static_cast<uint64_t>(static_cast<uint8_t>(entry.depth)) << 16 |
+            static_cast<uint64_t>(entry.bound) << 24 |
+            static_cast<uint64_t>(entry.generation) << 32 |
+            static_cast<uint64_t>(static_cast<uint8_t>(entry.move.from)) << 40 |
+            static_cast<uint64_t>(static_cast<uint8_t>(entry.move.to)) << 48;
+}
+
+PicariaTranspositionTable::Entry PicariaTranspositionTable::unpack(uint64_t data) {
+    PicariaMove move = PicariaMove::slide(static_cast<int8_t>(data >> 40), static_cast<int8_t>(data >> 48));
+    return Entry{ static_cast<int16_t>(data), static_cast<int8_t>(data >> 16),
+                  static_cast<uint8_t>(data >> 24), static_cast<uint8_t>(data >> 32), move };
+}
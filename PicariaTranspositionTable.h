@@ -0,0 +1,65 @@
+#ifndef PICARIATRANSPOSITIONTABLE_H
+#define PICARIATRANSPOSITIONTABLE_H
+
+#include "PicariaMove.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Fixed size hash table of search results, keyed by Zobrist hash. The
+// memory given at construction is never exceeded: a full table replaces
+// entries from older searches first, then shallower ones.
+//
+// Any number of threads may probe and store at once without locks. Each
+// slot holds the packed entry and the key XOR the entry in two atomic
+// words; a slot torn by concurrent stores fails the XOR check and simply
+// reads as a miss.
+class PicariaTranspositionTable {
+public:
+    enum Bound {
+        NoBound,
+        ExactBound,
+        LowerBound,
+        UpperBound
+    };
+
+    struct Entry {
+        int16_t score;
+        int8_t depth;
+        uint8_t bound;
+        uint8_t generation;
+        PicariaMove move;
+    };
+
+    explicit PicariaTranspositionTable(size_t bytes = 4 << 20);
+
+    size_t size() const { return m_mask + 1; }
+    size_t bytes() const { return this->size() * sizeof(Slot); }
+
+    // Copies the entry stored for key into entry; false on a miss.
+    bool probe(uint64_t key, Entry& entry) const;
+    void store(uint64_t key, int score, int depth, Bound bound, PicariaMove move);
+
+    // Starts a new search: entries of earlier searches become replaceable.
+    // Not thread safe; call it before the search threads start.
+    void age() { m_generation++; }
+    void clear();
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask;
+    uint8_t m_generation;
+
+    static uint64_t pack(const Entry& entry);
+    static Entry unpack(uint64_t data);
+
+};
+
+#endif // PICARIATRANSPOSITIONTABLE_H
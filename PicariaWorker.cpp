@@ -0,0 +1,90 @@
+#include "PicariaWorker.h"
+#include "PicariaEngine.h"
+
+#include <QMutexLocker>
+#include <QRunnable>
+
+#include <functional>
+
+namespace {
+
+class Task : public QRunnable {
+public:
+    explicit Task(std::function<void()> function) : m_function(std::move(function)) {}
+    void run() override { m_function(); }
+
+private:
+    std::function<void()> m_function;
+};
+
+}
+
+PicariaWorker::PicariaWorker(PicariaEngine* engine, QObject *parent)
+    : QObject(parent),
+      m_engine(engine),
+      m_ticket(0) {
+    // One engine, so one request at a time.
+    m_pool.setMaxThreadCount(1);
+}
+
+PicariaWorker::~PicariaWorker() {
+    this->cancel();
+    m_pool.waitForDone();
+}
+
+void PicariaWorker::setEngine(PicariaEngine* engine) {
+    this->cancel();
+    m_pool.waitForDone();
+    m_engine.reset(engine);
+}
+
+void PicariaWorker::start(Request request, const PicariaBoard& board, int milliseconds) {
+    int ticket;
+    {
+        QMutexLocker locker(&m_mutex);
+        ticket = ++m_ticket;
+        m_engine->stop();
+    }
+
+    m_pool.start(new Task([this, ticket, request, board, milliseconds]() {
+        this->run(ticket, request, board, milliseconds);
+    }));
+}
+
+void PicariaWorker::cancel() {
+    QMutexLocker locker(&m_mutex);
+    ++m_ticket;
+    m_engine->stop();
+}
+
+void PicariaWorker::stop() {
+    QMutexLocker locker(&m_mutex);
+    m_engine->stop();
+}
+
+void PicariaWorker::clear() {
+    this->cancel();
+    m_pool.waitForDone();
+    m_engine->clear();
+}
+
+void PicariaWorker::run(int ticket, Request request, PicariaBoard board, int milliseconds) {
+    {
+        // Skip requests that were cancelled while they waited in the queue.
+        QMutexLocker locker(&m_mutex);
+        if (ticket != m_ticket)
+            return;
+        m_engine->resume();
+    }
+
+    PicariaMove move = m_engine->think(board, milliseconds);
+
+    // Deliver on the worker's own thread, unless cancelled in between.
+    QMetaObject::invokeMethod(this, [this, ticket, request, board, move]() {
+        QMutexLocker locker(&m_mutex);
+        bool current = ticket == m_ticket;
+        locker.unlock();
+        if (current)
+            emit finished(request, board, move);
+    }, Qt::QueuedConnection);
+}
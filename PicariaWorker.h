@@ -0,0 +1,58 @@
+#ifndef PICARIAWORKER_H
+#define PICARIAWORKER_H
+
+#include <QObject>
+#include <QMutex>
+#include <QThreadPool>
+
+#include <memory>
+
+#include "PicariaBoard.h"
+
+class PicariaEngine;
+
+// Runs an engine off the GUI thread. Requests are served one at a time on
+// a private thread pool; a new request cancels the one before it, and the
+// result of a cancelled request is never delivered. Results come back as
+// the finished() signal, queued to the thread the worker lives in.
+class PicariaWorker : public QObject {
+    Q_OBJECT
+
+public:
+    enum Request {
+        MoveRequest,
+        HintRequest,
+        PonderRequest
+    };
+    Q_ENUM(Request)
+
+    // Takes ownership of the engine.
+    explicit PicariaWorker(PicariaEngine* engine, QObject *parent = nullptr);
+    virtual ~PicariaWorker();
+
+    void setEngine(PicariaEngine* engine);
+
+    void start(Request request, const PicariaBoard& board, int milliseconds);
+
+public slots:
+    // Drops the current request and its result.
+    void cancel();
+    // Ends the current request early; its best move so far is delivered.
+    void stop();
+    // Cancels everything and clears what the engine learned.
+    void clear();
+
+signals:
+    void finished(int request, const PicariaBoard& board, PicariaMove move);
+
+private:
+    QThreadPool m_pool;
+    QMutex m_mutex;
+    std::unique_ptr<PicariaEngine> m_engine;
+    int m_ticket;
+
+    void run(int ticket, Request request, PicariaBoard board, int milliseconds);
+
+};
+
+#endif // PICARIAWORKER_H
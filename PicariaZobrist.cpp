@@ -0,0 +1,43 @@
+#include "PicariaZobrist.h"
+
+namespace {
+
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+}
+
+PicariaZobrist::Keys::Keys() {
+    uint64_t state = 0x5069636172696121ull;
+    for (int player = 0; player < 2; ++player)
+        for (int id = 0; id < PicariaBoard::HoleCount; ++id)
+            pieces[player][id] = splitmix64(state);
+    for (int count = 0; count <= PicariaBoard::MaxDrops; ++count)
+        drops[count] = splitmix64(state);
+    blue = splitmix64(state);
+    thirteen = splitmix64(state);
+}
+
+const PicariaZobrist::Keys& PicariaZobrist::keys() {
+    static const Keys instance;
+    return instance;
+}
+
+uint64_t PicariaZobrist::key(const PicariaBoard& board) {
+    const Keys& k = PicariaZobrist::keys();
+    uint64_t key = k.drops[board.dropCount()];
+
+    for (int player = 0; player < 2; ++player)
+        for (uint16_t set = board.pieces(static_cast<PicariaBoard::Player>(player)); set != 0; set &= set - 1)
+            key ^= k.pieces[player][__builtin_ctz(set)];
+    if (board.player() == PicariaBoard::BluePlayer)
+        key ^= k.blue;
+    if (board.mode() == PicariaBoard::ThirteenHoles)
+        key ^= k.thirteen;
+
+    return key;
+}
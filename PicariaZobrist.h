@@ -0,0 +1,29 @@
+#ifndef PICARIAZOBRIST_H
+#define PICARIAZOBRIST_H
+
+#include "PicariaBoard.h"
+
+#include <cstdint>
+
+// Zobrist hashing of a position: one random key per piece on a hole,
+// plus keys for the side to move, the drop count (which also gives the
+// phase) and the board mode. Keys are fixed, so hashes are reproducible.
+class PicariaZobrist {
+public:
+    static uint64_t key(const PicariaBoard& board);
+
+private:
+    struct Keys {
+        uint64_t pieces[2][PicariaBoard::HoleCount];
+        uint64_t drops[PicariaBoard::MaxDrops + 1];
+        uint64_t blue;
+        uint64_t thirteen;
+
+        Keys();
+    };
+
+    static const Keys& keys();
+
+};
+
+#endif // PICARIAZOBRIST_H
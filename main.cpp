@@ -1,8 +1,35 @@
 #include "Picaria.h"
+#include "PicariaDataFile.h"
+#include "PicariaProtocol.h"
 
 #include <QApplication>
+#include <QCoreApplication>
+
+#include <cstring>
+#include <iostream>
+
+// picaria --headless speaks the PicariaProtocol line protocol on stdin and
+// stdout instead of opening a window. It only needs a QCoreApplication, so
+// it runs without a display.
+static int headless(int argc, char *argv[]) {
+    QCoreApplication a(argc, argv);
+
+    std::shared_ptr<const PicariaTablebase> tablebase;
+    std::shared_ptr<const PicariaBook> book;
+    PicariaDataFile::load(Picaria::openDataFile(), tablebase, book);
+
+    std::ios::sync_with_stdio(false);
+    PicariaProtocol protocol(tablebase, book);
+    protocol.run(std::cin, std::cout);
+
+    return 0;
+}
 
 int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i)
+        if (std::strcmp(argv[i], "--headless") == 0)
+            return headless(argc, argv);
+
     QApplication a(argc, argv);
     Picaria w;
 
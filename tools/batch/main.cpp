@@ -0,0 +1,133 @@
+#include "PicariaBatch.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Measures the batch evaluator on random positions of both boards, taken
+// from random games in both phases, with every kernel the processor
+// supports, and checks that each kernel agrees with the scalar one.
+//
+// usage: picaria-batch [positions] [rounds]    (default: 1000000, 20)
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+uint64_t next(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545f4914f6cdd1dull;
+}
+
+struct Batch {
+    std::vector<uint16_t> red;
+    std::vector<uint16_t> blue;
+    std::vector<uint8_t> player;
+
+    PicariaBatch::Positions positions() const {
+        return { red.size(), red.data(), blue.data(), player.data() };
+    }
+};
+
+struct Output {
+    std::vector<uint8_t> lines;
+    std::vector<uint8_t> redMobility;
+    std::vector<uint8_t> blueMobility;
+    std::vector<int16_t> scores;
+
+    explicit Output(size_t count) : lines(count), redMobility(count), blueMobility(count), scores(count) {}
+
+    PicariaBatch::Results results() {
+        return { lines.data(), redMobility.data(), blueMobility.data(), scores.data() };
+    }
+
+    bool operator==(const Output& other) const {
+        return lines == other.lines && redMobility == other.redMobility &&
+                blueMobility == other.blueMobility && scores == other.scores;
+    }
+};
+
+Batch generate(PicariaBoard::Mode mode, size_t count, uint64_t seed) {
+    Batch batch;
+    batch.red.reserve(count);
+    batch.blue.reserve(count);
+    batch.player.reserve(count);
+
+    uint64_t random = seed * 0x9e3779b97f4a7c15ull | 1;
+    PicariaBoard board(mode);
+    while (batch.red.size() < count) {
+        batch.red.push_back(board.pieces(PicariaBoard::RedPlayer));
+        batch.blue.push_back(board.pieces(PicariaBoard::BluePlayer));
+        batch.player.push_back(static_cast<uint8_t>(board.player()));
+
+        PicariaMoveList list = board.moves();
+        PicariaMove move = list[static_cast<int>(next(random) % static_cast<uint64_t>(list.count))];
+        PicariaBoard::Player mover = board.player();
+        board.play(move);
+        if (board.hasLineThrough(mover, move.to) || !board.hasMoves() || next(random) % 64 == 0) {
+            // Ended positions are scored too: they are where lines show.
+            batch.red.push_back(board.pieces(PicariaBoard::RedPlayer));
+            batch.blue.push_back(board.pieces(PicariaBoard::BluePlayer));
+            batch.player.push_back(static_cast<uint8_t>(board.player()));
+            board = PicariaBoard(mode);
+        }
+    }
+    batch.red.resize(count);
+    batch.blue.resize(count);
+    batch.player.resize(count);
+    return batch;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 20;
+    if (count == 0 || rounds <= 0) {
+        std::fprintf(stderr, "usage: picaria-batch [positions] [rounds]\n");
+        return 2;
+    }
+
+    const char* names[2] = { "9 holes", "13 holes" };
+    const PicariaBatch::Kernel kernels[] = { PicariaBatch::ScalarKernel, PicariaBatch::Sse2Kernel, PicariaBatch::Avx2Kernel };
+    bool same = true;
+
+    for (int mode = 0; mode < 2; ++mode) {
+        PicariaBoard::Mode m = static_cast<PicariaBoard::Mode>(mode);
+        Batch batch = generate(m, count, static_cast<uint64_t>(mode) + 1);
+        Output reference(count);
+        PicariaBatch::evaluate(m, batch.positions(), reference.results(), PicariaBatch::ScalarKernel);
+
+        size_t lines = 0;
+        for (uint8_t line : reference.lines)
+            lines += line != 0;
+
+        double scalar = 0;
+        for (PicariaBatch::Kernel kernel : kernels) {
+            if (!PicariaBatch::isSupported(kernel))
+                continue;
+
+            Output output(count);
+            Clock::time_point begin = Clock::now();
+            for (int round = 0; round < rounds; ++round)
+                PicariaBatch::evaluate(m, batch.positions(), output.results(), kernel);
+            double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+            double rate = elapsed > 0 ? count * static_cast<double>(rounds) / elapsed : 0.0;
+            if (kernel == PicariaBatch::ScalarKernel)
+                scalar = rate;
+            bool agrees = output == reference;
+            same = same && agrees;
+            std::printf("%-8s %-6s %12.0f positions/s  speedup %5.2f  %zu with a line  %s\n", names[mode],
+                        PicariaBatch::name(kernel), rate, scalar > 0 ? rate / scalar : 0.0, lines,
+                        agrees ? "same" : "DIFFERENT");
+        }
+    }
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+#include "PicariaBook.h"
+#include "PicariaDataFile.h"
+#include "PicariaPool.h"
+#include "PicariaSearch.h"
+#include "PicariaSolver.h"
+#include "PicariaSymmetry.h"
+#include "PicariaTablebase.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Analyzes every line of the drop phase on both boards and writes the
+// opening book to the data file, keeping the tablebase it has; modes the
+// file has no tablebase for are solved first.
+//
+// Each position of the drop phase that can occur in a game is searched,
+// one per task on every core, to the end of the drop phase: the drop
+// that makes a line wins, and the positions the drops lead to are scored
+// from the tablebase. Every score is checked against the tablebase's own
+// value of the position. Symmetric positions are analyzed once, through
+// their canonical representative, which is the frame book moves are kept
+// in.
+//
+// usage: picaria-book [-t threads] [data]    (default: every core, picaria.db)
+
+namespace {
+
+const int winScore = PicariaSearch::WinScore;
+
+class Analysis {
+public:
+    Analysis(const PicariaTablebase& tablebase, PicariaBoard::Mode mode)
+        : m_tablebase(tablebase),
+          m_mode(mode),
+          m_mismatches(0) {
+    }
+
+    // Canonical positions of the drop phase, reached by drops from the
+    // start position and not yet over.
+    void enumerate() {
+        std::unordered_set<size_t> seen;
+        std::vector<PicariaBoard> layer(1, PicariaSymmetry::canonicalBoard(PicariaBoard(m_mode)));
+        seen.insert(PicariaTablebase::index(layer.front()));
+        while (!layer.empty()) {
+            m_positions.insert(m_positions.end(), layer.begin(), layer.end());
+            std::vector<PicariaBoard> next;
+            for (const PicariaBoard& board : layer) {
+                for (PicariaMove move : board.moves()) {
+                    PicariaBoard child = board;
+                    child.play(move);
+                    if (child.hasLineThrough(board.player(), move.to) || child.phase() != PicariaBoard::DropPhase)
+                        continue;
+                    child = PicariaSymmetry::canonicalBoard(child);
+                    if (seen.insert(PicariaTablebase::index(child)).second)
+                        next.push_back(child);
+                }
+            }
+            layer.swap(next);
+        }
+    }
+
+    void run(PicariaPool& pool) {
+        m_entries.resize(m_positions.size());
+        m_nodes.assign(static_cast<size_t>(pool.threads()), 0);
+        std::vector<char> mismatches(m_positions.size(), 0);
+        pool.run(m_positions.size(), [this, &mismatches](size_t index, int thread) {
+            mismatches[index] = !this->analyze(index, m_nodes[static_cast<size_t>(thread)]);
+        });
+        for (char mismatch : mismatches)
+            m_mismatches += static_cast<size_t>(mismatch);
+    }
+
+    size_t positions() const { return m_positions.size(); }
+    size_t mismatches() const { return m_mismatches; }
+    std::vector<PicariaBook::Entry> takeEntries() { return std::move(m_entries); }
+
+    uint64_t nodes() const {
+        uint64_t nodes = 0;
+        for (uint64_t count : m_nodes)
+            nodes += count;
+        return nodes;
+    }
+
+    // The value of the start position, from the first player's side.
+    int startScore() const { return m_positions.empty() ? 0 : m_entries.front().score; }
+
+private:
+    const PicariaTablebase& m_tablebase;
+    PicariaBoard::Mode m_mode;
+    std::vector<PicariaBoard> m_positions;
+    std::vector<PicariaBook::Entry> m_entries;
+    std::vector<uint64_t> m_nodes;
+    size_t m_mismatches;
+
+    // Finds the best drop of one position and checks its score against
+    // the tablebase; false on a mismatch.
+    bool analyze(size_t index, uint64_t& nodes) {
+        const PicariaBoard& board = m_positions[index];
+        PicariaMove best;
+        int score = this->search(board, 0, -winScore - 1, winScore + 1, nodes, &best);
+
+        PicariaBook::Entry& entry = m_entries[index];
+        entry.index = static_cast<uint32_t>(PicariaTablebase::index(board));
+        entry.from = best.from;
+        entry.to = best.to;
+        entry.score = static_cast<int16_t>(score);
+        return score == this->tablebaseScore(board, 0);
+    }
+
+    // Negamax with alpha-beta over the rest of the drop phase. Distances
+    // count plies from the analyzed position, as in PicariaSearch.
+    int search(const PicariaBoard& board, int ply, int alpha, int beta, uint64_t& nodes, PicariaMove* best) {
+        ++nodes;
+        for (PicariaMove move : board.moves()) {
+            PicariaBoard child = board;
+            child.play(move);
+
+            int score;
+            if (child.hasLineThrough(board.player(), move.to))
+                score = winScore - (ply + 1);
+            else if (child.phase() != PicariaBoard::DropPhase)
+                score = -this->tablebaseScore(child, ply + 1);
+            else
+                score = -this->search(child, ply + 1, -beta, -alpha, nodes, nullptr);
+
+            if (score > alpha) {
+                alpha = score;
+                if (best != nullptr)
+                    *best = move;
+                if (alpha >= beta)
+                    break;
+            }
+        }
+        return alpha;
+    }
+
+    int tablebaseScore(const PicariaBoard& board, int ply) const {
+        int distance = ply + m_tablebase.distance(board);
+        switch (m_tablebase.result(board)) {
+        case PicariaTablebase::WinResult:
+            return winScore - distance;
+        case PicariaTablebase::LossResult:
+            return -(winScore - distance);
+        default:
+            return 0;
+        }
+    }
+
+};
+
+}
+
+int main(int argc, char *argv[]) {
+    int threads = 0;
+    const char* path = "picaria.db";
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "-t" && i + 1 < argc)
+            threads = std::atoi(argv[++i]);
+        else if (argument[0] != '-')
+            path = argv[i];
+        else {
+            std::fprintf(stderr, "usage: picaria-book [-t threads] [data]\n");
+            return 2;
+        }
+    }
+
+    const char* names[2] = { "9 holes", "13 holes" };
+    PicariaTablebase tablebase;
+    tablebase.load(path);
+
+    PicariaPool pool(threads);
+    PicariaBook book;
+    bool valid = true;
+    for (int mode = 0; mode < 2; ++mode) {
+        PicariaBoard::Mode m = static_cast<PicariaBoard::Mode>(mode);
+        if (tablebase.isEmpty(m)) {
+            auto begin = std::chrono::steady_clock::now();
+            PicariaSolver solver(m);
+            solver.solve();
+            tablebase.setEntries(m, solver.takeEntries());
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            std::printf("%s: no tablebase in %s, solved in %.3f s\n", names[mode], path, elapsed);
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        Analysis analysis(tablebase, m);
+        analysis.enumerate();
+        analysis.run(pool);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        std::printf("%s: %zu positions, %llu nodes, %d threads, %.3f s, %.0f positions/s, start score %d, "
+                    "%zu tablebase mismatches\n",
+                    names[mode], analysis.positions(), static_cast<unsigned long long>(analysis.nodes()),
+                    pool.threads(), elapsed, elapsed > 0 ? analysis.positions() / elapsed : 0.0,
+                    analysis.startScore(), analysis.mismatches());
+        valid = valid && analysis.mismatches() == 0;
+        book.setEntries(m, analysis.takeEntries());
+    }
+
+    if (!valid) {
+        std::fprintf(stderr, "the analysis disagrees with the tablebase, %s not written\n", path);
+        return 1;
+    }
+    if (!PicariaDataFile::save(path, &tablebase, &book)) {
+        std::fprintf(stderr, "could not write %s\n", path);
+        return 1;
+    }
+    std::printf("wrote %s\n", path);
+
+    return 0;
+}
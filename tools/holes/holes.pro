@@ -0,0 +1,19 @@
+QT += core gui widgets
+
+TEMPLATE = app
+TARGET = picaria-holes
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+SOURCES += \
+    main.cpp \
+    ../../BoardView.cpp
+
+HEADERS += \
+    ../../BoardView.h
+
+include(../../PicariaCore.pri)
+
+RESOURCES += \
+    ../../Picaria.qrc
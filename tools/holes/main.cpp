@@ -0,0 +1,102 @@
+#include "BoardView.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QPixmap>
+#include <QPushButton>
+#include <QWidget>
+
+#include <cstdio>
+#include <cstdlib>
+
+// Measures the cost of the hole updates of one click, repaint included:
+// a piece is picked, its eight neighbours are marked selectable, the
+// piece slides and the marks are cleared. The old board was thirteen
+// buttons that decoded a PNG resource on every change and repainted one
+// by one; the board view repaints the changed squares in one paint, and
+// setBoard() applies each step of the click as a single diff.
+//
+// usage: picaria-holes [clicks] [-platform offscreen]
+
+namespace {
+
+const int neighbours[] = { 1, 3, 4, 5, 7, 8, 9, 11 };
+
+const char* const paths[] = { ":empty", ":red", ":blue", ":selectable" };
+
+// The red piece in the middle of the thirteen holes board goes up.
+template <typename Set>
+void click(Set set) {
+    for (int id : neighbours)
+        set(id, BoardView::SelectableState);
+    set(6, BoardView::EmptyState);
+    set(1, BoardView::RedState);
+    for (int id : neighbours)
+        if (id != 1)
+            set(id, BoardView::EmptyState);
+    set(1, BoardView::EmptyState);
+    set(6, BoardView::RedState);
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    QApplication app(argc, argv);
+    int clicks = argc > 1 ? std::atoi(argv[1]) : 1000;
+    if (clicks <= 0)
+        clicks = 1;
+
+    QWidget buttonWindow;
+    QPushButton* buttons[PicariaBoard::HoleCount];
+    for (int id = 0; id < PicariaBoard::HoleCount; ++id) {
+        buttons[id] = new QPushButton(&buttonWindow);
+        buttons[id]->setGeometry(id % 5 * 100, id / 5 * 100, 100, 100);
+        buttons[id]->setIconSize(QSize(50, 50));
+        buttons[id]->setFlat(true);
+    }
+    buttonWindow.show();
+
+    BoardView view;
+    view.setMode(PicariaBoard::ThirteenHoles);
+    view.setState(6, BoardView::RedState);
+    view.show();
+    app.processEvents();
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < clicks; ++i) {
+        click([&](int id, BoardView::State state) { buttons[id]->setIcon(QPixmap(paths[state])); });
+        app.processEvents();
+    }
+    double decoded = timer.nsecsElapsed() / 1000.0 / clicks;
+
+    timer.restart();
+    for (int i = 0; i < clicks; ++i) {
+        click([&](int id, BoardView::State state) { view.setState(id, state); });
+        app.processEvents();
+    }
+    double painted = timer.nsecsElapsed() / 1000.0 / clicks;
+
+    PicariaBoard before(PicariaBoard::ThirteenHoles, 1u << 6, 0, PicariaBoard::RedPlayer);
+    PicariaBoard after(PicariaBoard::ThirteenHoles, 1u << 1, 0, PicariaBoard::RedPlayer);
+    int changes = 0;
+    QObject::connect(&view, &BoardView::statesChanged, [&changes]() { ++changes; });
+
+    timer.restart();
+    for (int i = 0; i < clicks; ++i) {
+        view.setBoard(before, before.destinations(6));
+        app.processEvents();
+        view.setBoard(after);
+        app.processEvents();
+        view.setBoard(before);
+        app.processEvents();
+    }
+    double batched = timer.nsecsElapsed() / 1000.0 / clicks;
+
+    std::printf("13 buttons:  %8.2f us per click\n", decoded);
+    std::printf("board view:  %8.2f us per click, %.1fx faster\n", painted, painted > 0 ? decoded / painted : 0.0);
+    std::printf("batched:     %8.2f us per click, %.1fx faster, %.1f updates per step\n",
+                batched, batched > 0 ? decoded / batched : 0.0, changes / (3.0 * clicks));
+
+    return 0;
+}
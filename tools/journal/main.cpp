@@ -0,0 +1,114 @@
+#include "PicariaJournal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Measures the journal: moves per second and the time a move waits for
+// its append, for each sync mode, playing random games into a journal
+// file. The last game is restored afterwards and checked against the
+// moves played, after every mode.
+//
+// usage: picaria-journal [path] [moves]    (default: picaria.journal, 20000)
+
+namespace {
+
+struct Setting {
+    const char* name;
+    PicariaJournal::Sync sync;
+    int batch;
+    int milliseconds;
+};
+
+const Setting settings[] = {
+    { "none", PicariaJournal::NoSync, 1, 1 },
+    { "batch 256/100ms", PicariaJournal::BatchSync, 256, 100 },
+    { "batch 64/100ms", PicariaJournal::BatchSync, 64, 100 },
+    { "batch 8/10ms", PicariaJournal::BatchSync, 8, 10 },
+    { "full", PicariaJournal::FullSync, 1, 1 }
+};
+
+// Random games longer than this start over.
+const size_t maxPlies = 200;
+
+typedef std::chrono::steady_clock Clock;
+
+uint64_t next(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545f4914f6cdd1dull;
+}
+
+bool run(const std::string& path, const Setting& setting, uint64_t count) {
+    PicariaJournal journal;
+    if (!journal.open(path, setting.sync, setting.batch, setting.milliseconds)) {
+        std::perror(path.c_str());
+        return false;
+    }
+
+    uint64_t random = 1;
+    PicariaGame game;
+    journal.start(game.mode());
+    std::vector<double> latencies;
+    latencies.reserve(count);
+
+    Clock::time_point begin = Clock::now();
+    for (uint64_t i = 0; i < count; ++i) {
+        if (game.isOver() || game.ply() >= maxPlies) {
+            game.reset(game.mode() == PicariaBoard::NineHoles ? PicariaBoard::ThirteenHoles : PicariaBoard::NineHoles);
+            journal.start(game.mode());
+        }
+
+        // One in eight moves is taken back, as users do.
+        Clock::time_point start = Clock::now();
+        if (game.canUndo() && next(random) % 8 == 0) {
+            game.undo();
+            journal.undo();
+        }
+        else {
+            PicariaMoveList list = game.board().moves();
+            PicariaMove move = list[static_cast<int>(next(random) % static_cast<uint64_t>(list.count))];
+            game.play(move);
+            journal.play(move);
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+    journal.close();
+
+    PicariaGame restored;
+    bool same = PicariaJournal::restore(path, restored) && restored.mode() == game.mode() &&
+            restored.moves() == game.moves() && restored.ply() == game.ply();
+
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("%-16s %10.0f moves/s  p50 %8.1f us  p99 %8.1f us  max %8.1f us  %6llu syncs  %s\n",
+                setting.name, count / elapsed, latencies[latencies.size() / 2],
+                latencies[latencies.size() * 99 / 100], latencies.back(),
+                static_cast<unsigned long long>(journal.syncs()), same ? "restored" : "RESTORE MISMATCH");
+    return same;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    std::string path = argc > 1 ? argv[1] : "picaria.journal";
+    uint64_t count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+    if (count == 0) {
+        std::fprintf(stderr, "usage: picaria-journal [path] [moves]\n");
+        return 2;
+    }
+
+    // Start from an empty journal, not whatever the path held.
+    std::remove(path.c_str());
+
+    bool same = true;
+    for (const Setting& setting : settings)
+        same = run(path, setting, count) && same;
+    std::remove(path.c_str());
+    return same ? 0 : 1;
+}
@@ -0,0 +1,38 @@
+#include "PicariaMcts.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+// Measures Monte Carlo playouts per second from the start position of both
+// modes, doubling the thread count up to maxThreads.
+//
+// usage: picaria-mcts [maxThreads] [milliseconds]
+int main(int argc, char *argv[]) {
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+    int milliseconds = argc > 2 ? std::atoi(argv[2]) : 1000;
+    const char* names[2] = { "9 holes", "13 holes" };
+
+    if (maxThreads <= 0)
+        maxThreads = 1;
+
+    for (int mode = 0; mode < 2; ++mode) {
+        double single = 0;
+        for (int threads = 1; ; threads = std::min(threads * 2, maxThreads)) {
+            PicariaMcts mcts(threads);
+            PicariaBoard board(static_cast<PicariaBoard::Mode>(mode));
+            PicariaMove move = mcts.think(board, milliseconds);
+
+            double rate = mcts.playoutsPerSecond();
+            if (threads == 1)
+                single = rate;
+            std::printf("%s: %2d threads, %12.0f playouts/s, speedup %5.2f, move %d\n",
+                        names[mode], threads, rate, single > 0 ? rate / single : 0.0, move.to + 1);
+            if (threads == maxThreads)
+                break;
+        }
+    }
+
+    return 0;
+}
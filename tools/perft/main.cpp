@@ -0,0 +1,248 @@
+#include "PicariaBoard.h"
+#include "PicariaRules.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Counts every move sequence of the given length from the start position
+// of both modes, and checks the rules engine against a reference move
+// generator. Run it after any change to move generation or win detection:
+// the counts must match the known ones, and the check must pass.
+//
+// usage: picaria-perft [depth] [verifyDepth]    (default: 8 and 8)
+
+namespace {
+
+// The rules as the original user interface implemented them, kept as
+// plain lists on purpose: neighbours in the order findSelectable() tried
+// them, and lines as checkRow(), checkCol(), checkDiagonal() and
+// checkAntiDiagonal() tested them. Nothing here shares code with the
+// engine.
+struct Reference {
+    static const int End = -1;
+
+    static const int* neighbours(int mode, int id) {
+        static const int nine[13][9] = {
+            { 1, 5, 6, End },
+            { 0, 2, 5, 6, 7, End },
+            { 6, 1, 7, End },
+            { End },
+            { End },
+            { 0, 1, 6, 10, 11, End },
+            { 0, 1, 2, 5, 7, 10, 11, 12, End },
+            { 1, 2, 6, 11, 12, End },
+            { End },
+            { End },
+            { 5, 6, 11, End },
+            { 5, 6, 7, 10, 12, End },
+            { 6, 7, 11, End }
+        };
+        static const int thirteen[13][9] = {
+            { 1, 5, 3, End },
+            { 0, 2, 3, 6, 4, End },
+            { 4, 1, 7, End },
+            { 0, 1, 5, 6, End },
+            { 2, 1, 7, 6, End },
+            { 0, 3, 6, 10, 8, End },
+            { 1, 4, 7, 9, 11, 8, 5, 3, End },
+            { 4, 2, 6, 9, 12, End },
+            { 5, 6, 10, 11, End },
+            { 6, 11, 7, 12, End },
+            { 5, 8, 11, End },
+            { 8, 6, 9, 10, 12, End },
+            { 9, 7, 11, End }
+        };
+        return mode == PicariaBoard::NineHoles ? nine[id] : thirteen[id];
+    }
+
+    static bool isHole(int mode, int id) {
+        return mode == PicariaBoard::ThirteenHoles || (id != 3 && id != 4 && id != 8 && id != 9);
+    }
+
+    static bool hasLine(int mode, const int* cells, int cell) {
+        static const int nine[][3] = {
+            { 0, 1, 2 }, { 5, 6, 7 }, { 10, 11, 12 },
+            { 0, 5, 10 }, { 1, 6, 11 }, { 2, 7, 12 },
+            { 0, 6, 12 },
+            { 2, 6, 10 }
+        };
+        static const int thirteen[][3] = {
+            { 0, 1, 2 }, { 5, 6, 7 }, { 10, 11, 12 },
+            { 0, 5, 10 }, { 1, 6, 11 }, { 2, 7, 12 },
+            { 0, 3, 6 }, { 3, 6, 9 }, { 6, 9, 12 }, { 5, 8, 11 }, { 1, 4, 7 },
+            { 2, 4, 6 }, { 4, 6, 8 }, { 6, 8, 10 }, { 1, 3, 5 }, { 7, 9, 11 }
+        };
+        const int (*lines)[3] = mode == PicariaBoard::NineHoles ? nine : thirteen;
+        int count = mode == PicariaBoard::NineHoles ? 8 : 16;
+        for (int i = 0; i < count; ++i)
+            if (cells[lines[i][0]] == cell && cells[lines[i][1]] == cell && cells[lines[i][2]] == cell)
+                return true;
+        return false;
+    }
+
+    int mode;
+    int cells[PicariaBoard::HoleCount];
+    int player;
+    int drops;
+
+    explicit Reference(int mode) : mode(mode), cells(), player(PicariaBoard::RedPlayer), drops(0) {}
+
+    int cell() const { return player == PicariaBoard::RedPlayer ? PicariaBoard::RedCell : PicariaBoard::BlueCell; }
+
+    std::vector<PicariaMove> moves() const {
+        std::vector<PicariaMove> list;
+        for (int id = 0; id < PicariaBoard::HoleCount; ++id) {
+            if (!Reference::isHole(mode, id))
+                continue;
+            if (drops < PicariaBoard::MaxDrops) {
+                if (cells[id] == PicariaBoard::EmptyCell)
+                    list.push_back(PicariaMove::drop(id));
+            }
+            else if (cells[id] == this->cell()) {
+                for (const int* to = Reference::neighbours(mode, id); *to != End; ++to)
+                    if (cells[*to] == PicariaBoard::EmptyCell)
+                        list.push_back(PicariaMove::slide(id, *to));
+            }
+        }
+        return list;
+    }
+
+    void play(PicariaMove move) {
+        if (move.isDrop())
+            ++drops;
+        else
+            cells[move.from] = PicariaBoard::EmptyCell;
+        cells[move.to] = this->cell();
+        player = 1 - player;
+    }
+};
+
+// Leaf counts from the start position, by mode and depth.
+const int knownDepth = 8;
+const uint64_t known[2][knownDepth + 1] = {
+    { 1, 9, 72, 504, 3024, 15120, 56160, 254448, 1136592 },
+    { 1, 13, 156, 1716, 17160, 154440, 1175040, 8408592, 59195952 }
+};
+
+bool lessThan(PicariaMove a, PicariaMove b) {
+    return a.from != b.from ? a.from < b.from : a.to < b.to;
+}
+
+// Leaf count of the engine's move tree, made and unmade on one board. A
+// move that makes a line ends the game, so it is a leaf at any depth.
+template <typename Rules>
+uint64_t perft(PicariaBoard& board, int depth) {
+    PicariaMoveList list;
+    Rules::generate(board, list);
+    if (depth == 1)
+        return static_cast<uint64_t>(list.count);
+
+    const PicariaBoard::Player player = board.player();
+    uint64_t nodes = 0;
+    for (PicariaMove move : list) {
+        board.play(move);
+        nodes += Rules::hasLineThrough(board.pieces(player), move.to) ? 1 : perft<Rules>(board, depth - 1);
+        board.undo(move);
+    }
+    return nodes;
+}
+
+// Walks the engine and the reference in lockstep and compares the board,
+// the move list and the end of the game at every node.
+bool verify(const PicariaBoard& board, const Reference& reference, int depth, uint64_t& nodes) {
+    ++nodes;
+
+    for (int id = 0; id < PicariaBoard::HoleCount; ++id) {
+        if (board.isHole(id) != Reference::isHole(reference.mode, id) ||
+                (board.isHole(id) && board.cellAt(id) != reference.cells[id])) {
+            std::printf("hole %d differs\n", id + 1);
+            return false;
+        }
+    }
+    if (board.player() != reference.player) {
+        std::printf("side to move differs\n");
+        return false;
+    }
+
+    for (int player = 0; player < 2; ++player) {
+        bool line = board.hasLine(static_cast<PicariaBoard::Player>(player));
+        if (line != Reference::hasLine(reference.mode, reference.cells, player + 1)) {
+            std::printf("line of player %d differs\n", player);
+            return false;
+        }
+        if (line)
+            return true;
+    }
+
+    PicariaMoveList list = board.moves();
+    std::vector<PicariaMove> engine(list.begin(), list.end());
+    std::vector<PicariaMove> expected = reference.moves();
+    std::sort(engine.begin(), engine.end(), lessThan);
+    std::sort(expected.begin(), expected.end(), lessThan);
+    if (engine != expected || board.hasMoves() != !expected.empty()) {
+        std::printf("moves differ: %zu, expected %zu\n", engine.size(), expected.size());
+        return false;
+    }
+
+    if (depth == 0)
+        return true;
+
+    for (PicariaMove move : expected) {
+        PicariaBoard child = board;
+        Reference next = reference;
+        child.play(move);
+        next.play(move);
+        if (!verify(child, next, depth - 1, nodes)) {
+            std::printf("  after %d-%d\n", move.from + 1, move.to + 1);
+            return false;
+        }
+
+        // Unmaking must give back the position exactly.
+        child.undo(move);
+        if (child != board) {
+            std::printf("undo of %d-%d differs\n", move.from + 1, move.to + 1);
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    int depth = argc > 1 ? std::atoi(argv[1]) : 8;
+    int verifyDepth = argc > 2 ? std::atoi(argv[2]) : knownDepth;
+    const char* names[2] = { "9 holes", "13 holes" };
+
+    bool passed = true;
+    for (int mode = 0; mode < 2; ++mode) {
+        PicariaBoard board(static_cast<PicariaBoard::Mode>(mode));
+
+        for (int d = 1; d <= depth; ++d) {
+            auto begin = std::chrono::steady_clock::now();
+            PicariaBoard root = board;
+            uint64_t nodes = picariaDispatch(board.mode(), [&](auto rules) {
+                return perft<decltype(rules)>(root, d);
+            });
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+            bool wrong = d <= knownDepth && nodes != known[mode][d];
+            std::printf("%s: depth %2d, %14llu nodes, %8.3f s, %12.0f nodes/s%s\n",
+                        names[mode], d, static_cast<unsigned long long>(nodes), elapsed,
+                        elapsed > 0 ? nodes / elapsed : 0.0, wrong ? ", WRONG" : "");
+            passed = passed && !wrong;
+        }
+
+        uint64_t nodes = 0;
+        bool ok = verify(board, Reference(mode), verifyDepth, nodes);
+        std::printf("%s: reference check to depth %d %s, %llu nodes\n", names[mode], verifyDepth,
+                    ok ? "passed" : "FAILED", static_cast<unsigned long long>(nodes));
+        passed = passed && ok;
+    }
+
+    return passed ? 0 : 1;
+}
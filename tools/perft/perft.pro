@@ -0,0 +1,10 @@
+TEMPLATE = app
+TARGET = picaria-perft
+
+CONFIG += console c++17
+CONFIG -= app_bundle qt
+
+SOURCES += \
+    main.cpp
+
+include(../../PicariaCore.pri)
@@ -0,0 +1,171 @@
+#include "PicariaRecord.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Replays and validates recorded games in one streaming pass, converts
+// between the binary and text formats, and generates random games to
+// test with. See PicariaRecord for the formats.
+//
+// usage: picaria-replay validate file...
+//        picaria-replay convert input output [binary|text]    (default: binary)
+//        picaria-replay generate output [games] [seed] [binary|text]
+//                                              (default: 1000000, 1, binary)
+
+namespace {
+
+// Random games longer than this are recorded as draws.
+const size_t maxPlies = 200;
+
+// Invalid games reported one by one; the rest are only counted.
+const int maxReported = 10;
+
+typedef std::chrono::steady_clock Clock;
+
+uint64_t next(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545f4914f6cdd1dull;
+}
+
+bool parseFormat(const char* name, PicariaRecord::Format& format) {
+    std::string text = name;
+    if (text != "binary" && text != "text")
+        return false;
+    format = text == "binary" ? PicariaRecord::BinaryFormat : PicariaRecord::TextFormat;
+    return true;
+}
+
+int validate(int count, char* paths[]) {
+    bool valid = true;
+    for (int i = 0; i < count; ++i) {
+        PicariaRecordReader reader;
+        if (!reader.open(paths[i])) {
+            std::fprintf(stderr, "%s: %s\n", paths[i], reader.error().c_str());
+            valid = false;
+            continue;
+        }
+
+        Clock::time_point begin = Clock::now();
+        PicariaRecord record;
+        uint64_t moves = 0;
+        uint64_t invalid = 0;
+        while (reader.read(record)) {
+            moves += record.moves.size();
+            size_t index = 0;
+            PicariaRecord::Error error = record.validate(&index);
+            if (error == PicariaRecord::NoError)
+                continue;
+            if (++invalid <= maxReported) {
+                if (error == PicariaRecord::IllegalMove)
+                    std::printf("%s: game %zu: illegal move %zu, %s\n", paths[i], reader.count(), index + 1,
+                                PicariaRecord::format(record.moves[index]).c_str());
+                else
+                    std::printf("%s: game %zu: wrong result\n", paths[i], reader.count());
+            }
+        }
+        double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        if (!reader.error().empty())
+            std::printf("%s: after game %zu: %s\n", paths[i], reader.count(), reader.error().c_str());
+        std::printf("%s: %zu games, %llu moves, %llu invalid, %.2f s, %.0f games/s\n", paths[i], reader.count(),
+                    static_cast<unsigned long long>(moves), static_cast<unsigned long long>(invalid), elapsed,
+                    elapsed > 0 ? reader.count() / elapsed : 0.0);
+        valid = valid && invalid == 0 && reader.error().empty();
+    }
+    return valid ? 0 : 1;
+}
+
+int convert(const char* input, const char* output, PicariaRecord::Format format) {
+    PicariaRecordReader reader;
+    PicariaRecordWriter writer;
+    if (!reader.open(input)) {
+        std::fprintf(stderr, "%s: %s\n", input, reader.error().c_str());
+        return 1;
+    }
+    if (!writer.open(output, format)) {
+        std::perror(output);
+        return 1;
+    }
+
+    PicariaRecord record;
+    while (reader.read(record))
+        if (!writer.write(record))
+            break;
+    if (!writer.close()) {
+        std::perror(output);
+        return 1;
+    }
+    if (!reader.error().empty()) {
+        std::fprintf(stderr, "%s: after game %zu: %s\n", input, reader.count(), reader.error().c_str());
+        return 1;
+    }
+    std::printf("%zu games\n", reader.count());
+    return 0;
+}
+
+int generate(const char* output, uint64_t games, uint64_t seed, PicariaRecord::Format format) {
+    PicariaRecordWriter writer;
+    if (!writer.open(output, format)) {
+        std::perror(output);
+        return 1;
+    }
+
+    uint64_t random = seed * 0x9e3779b97f4a7c15ull | 1;
+    PicariaRecord record;
+    for (uint64_t game = 0; game < games; ++game) {
+        PicariaBoard board(next(random) & 1 ? PicariaBoard::ThirteenHoles : PicariaBoard::NineHoles);
+        record.mode = board.mode();
+        record.result = PicariaRecord::Draw;
+        record.moves.clear();
+
+        while (record.moves.size() < maxPlies) {
+            PicariaMoveList list = board.moves();
+            PicariaMove move = list[static_cast<int>(next(random) % static_cast<uint64_t>(list.count))];
+            PicariaBoard::Player mover = board.player();
+            board.play(move);
+            record.moves.push_back(move);
+            if (board.hasLineThrough(mover, move.to) || !board.hasMoves()) {
+                record.result = mover == PicariaBoard::RedPlayer ? PicariaRecord::RedWin : PicariaRecord::BlueWin;
+                break;
+            }
+        }
+
+        if (!writer.write(record))
+            break;
+    }
+
+    if (!writer.close()) {
+        std::perror(output);
+        return 1;
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    std::string command = argc > 1 ? argv[1] : "";
+    PicariaRecord::Format format = PicariaRecord::BinaryFormat;
+
+    if (command == "validate" && argc > 2)
+        return validate(argc - 2, argv + 2);
+
+    if (command == "convert" && argc > 3 && (argc < 5 || parseFormat(argv[4], format)))
+        return convert(argv[2], argv[3], format);
+
+    if (command == "generate" && argc > 2 && (argc < 6 || parseFormat(argv[5], format))) {
+        uint64_t games = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1000000;
+        uint64_t seed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1;
+        return generate(argv[2], games, seed, format);
+    }
+
+    std::fprintf(stderr, "usage: picaria-replay validate file...\n"
+                         "       picaria-replay convert input output [binary|text]\n"
+                         "       picaria-replay generate output [games] [seed] [binary|text]\n");
+    return 2;
+}
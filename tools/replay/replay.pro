@@ -0,0 +1,10 @@
+TEMPLATE = app
+TARGET = picaria-replay
+
+CONFIG += console c++17
+CONFIG -= app_bundle qt
+
+SOURCES += \
+    main.cpp
+
+include(../../PicariaCore.pri)
@@ -0,0 +1,119 @@
+#include "PicariaSearch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Measures lazy SMP search throughput on a drawn thirteen holes position,
+// doubling the thread count up to maxThreads. The soft limit is the hard
+// one and draws never end the iterative deepening early, so every run
+// uses its full time.
+//
+// With --latency, plays random positions of both boards, gives the search
+// a hard budget of milliseconds per move and reports the time each move
+// took, how many overran the budget and the depth reached.
+//
+// usage: picaria-search [maxThreads] [milliseconds]
+//        picaria-search --latency [milliseconds] [positions] [threads]
+//                                              (default: 50, 200, 1)
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+uint64_t next(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545f4914f6cdd1dull;
+}
+
+int throughput(int maxThreads, int milliseconds) {
+    // Red on holes 7, 10 and 11, blue on holes 1, 3 and 4, red to move.
+    PicariaBoard board(PicariaBoard::ThirteenHoles, 0x640, 0x00d, PicariaBoard::RedPlayer);
+
+    PicariaSearch::Limits limits;
+    limits.softMilliseconds = milliseconds;
+    limits.hardMilliseconds = milliseconds;
+
+    double single = 0;
+    for (int threads = 1; ; threads = std::min(threads * 2, maxThreads)) {
+        PicariaSearch search(64 << 20, threads);
+        PicariaMove move = search.think(board, limits);
+
+        double rate = search.nodes() * 1000.0 / milliseconds;
+        if (threads == 1)
+            single = rate;
+        std::printf("%2d threads: depth %2d, score %5d, %12.0f nodes/s, speedup %5.2f, move %d-%d\n",
+                    threads, search.depth(), search.score(), rate, single > 0 ? rate / single : 0.0,
+                    move.from + 1, move.to + 1);
+        if (threads == maxThreads)
+            break;
+    }
+    return 0;
+}
+
+int latency(int milliseconds, int positions, int threads) {
+    PicariaSearch search(4 << 20, threads);
+    std::vector<double> times;
+    std::vector<int> depths;
+    uint64_t random = 1;
+
+    while (static_cast<int>(times.size()) < positions) {
+        // A random position a few plies into a random game, not over yet.
+        PicariaBoard board(next(random) & 1 ? PicariaBoard::ThirteenHoles : PicariaBoard::NineHoles);
+        int plies = static_cast<int>(next(random) % 12);
+        bool over = false;
+        for (int ply = 0; ply < plies && !over; ++ply) {
+            PicariaMoveList list = board.moves();
+            PicariaMove move = list[static_cast<int>(next(random) % static_cast<uint64_t>(list.count))];
+            PicariaBoard::Player mover = board.player();
+            board.play(move);
+            over = board.hasLineThrough(mover, move.to) || !board.hasMoves();
+        }
+        if (over)
+            continue;
+
+        Clock::time_point begin = Clock::now();
+        search.think(board, milliseconds);
+        times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - begin).count());
+        depths.push_back(search.depth());
+    }
+
+    int overruns = static_cast<int>(std::count_if(times.begin(), times.end(), [milliseconds](double time) {
+        return time > milliseconds;
+    }));
+    double total = 0;
+    for (double time : times)
+        total += time;
+    std::sort(times.begin(), times.end());
+    std::sort(depths.begin(), depths.end());
+    std::printf("%d positions, budget %d ms, %d threads: mean %.2f ms, p50 %.2f ms, p99 %.2f ms, max %.2f ms, "
+                "%d over budget, median depth %d\n",
+                positions, milliseconds, search.threads(), total / positions, times[times.size() / 2],
+                times[times.size() * 99 / 100], times.back(), overruns, depths[depths.size() / 2]);
+    return overruns == 0 ? 0 : 1;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--latency") == 0) {
+        int milliseconds = argc > 2 ? std::atoi(argv[2]) : 50;
+        int positions = argc > 3 ? std::atoi(argv[3]) : 200;
+        int threads = argc > 4 ? std::atoi(argv[4]) : 1;
+        return latency(std::max(milliseconds, 1), std::max(positions, 1), threads);
+    }
+
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+    int milliseconds = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+    if (maxThreads <= 0)
+        maxThreads = 1;
+    return throughput(maxThreads, std::max(milliseconds, 1));
+}
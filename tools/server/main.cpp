@@ -0,0 +1,571 @@
+#include "PicariaBoard.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Hosts any number of games for clients on a local socket, one poll()
+// loop on one thread. A game is a board and its owner; nothing else is
+// allocated per game. Clients send fixed size requests and get fixed size
+// updates back, in order, with the changed holes as a delta.
+//
+// The load generator plays random games on many connections at once and
+// reports the move rate, the moves per core-second of the server and the
+// latency of a move from request to update. Without a socket it hosts
+// its own server on a thread.
+//
+// usage: picaria-server serve [socket]    (default: picaria.sock)
+//        picaria-server load [connections] [games] [seconds] [socket]
+//                                         (default: 4, 1000 and 5)
+
+namespace {
+
+enum RequestType : uint8_t {
+    NewGame = 1,        // mode; replied with Created
+    Move = 2,           // game, from and to; replied with Moved or Rejected
+    EndGame = 3         // game; replied with Ended or Rejected
+};
+
+enum UpdateType : uint8_t {
+    Created = 1,
+    Moved = 2,
+    Rejected = 3,
+    Ended = 4
+};
+
+// Bits of Update::state.
+enum State : uint8_t {
+    BlueToMove = 1,
+    MovePhase = 2,
+    GameOver = 4,           // the player who moved last won
+    ThirteenHoles = 8
+};
+
+struct Request {
+    uint32_t game;
+    uint8_t type;
+    uint8_t mode;
+    int8_t from;
+    int8_t to;
+};
+
+// red and blue are the holes that changed for each player: xor them into
+// the pieces of the client's copy of the board.
+struct Update {
+    uint32_t game;
+    uint8_t type;
+    uint8_t state;
+    uint16_t red;
+    uint16_t blue;
+    uint16_t ply;
+};
+
+static_assert(sizeof(Request) == 8, "requests are sent as they are");
+static_assert(sizeof(Update) == 12, "updates are sent as they are");
+
+typedef std::chrono::steady_clock Clock;
+
+bool bindAddress(const std::string& path, sockaddr_un& address) {
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::fprintf(stderr, "socket path too long: %s\n", path.c_str());
+        return false;
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+class Server {
+public:
+    Server() : m_listener(-1), m_stopping(false), m_busy(0), m_moves(0), m_peak(0), m_hosted(0) {}
+    ~Server() { this->close(); }
+
+    bool listen(const std::string& path) {
+        sockaddr_un address;
+        if (!bindAddress(path, address))
+            return false;
+
+        ::unlink(path.c_str());
+        m_listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (m_listener < 0 || ::bind(m_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+                ::listen(m_listener, 128) != 0) {
+            std::perror(path.c_str());
+            return false;
+        }
+        ::fcntl(m_listener, F_SETFL, O_NONBLOCK);
+        m_path = path;
+        return true;
+    }
+
+    void run() {
+        std::vector<pollfd> fds;
+        while (!m_stopping.load(std::memory_order_relaxed)) {
+            fds.clear();
+            fds.push_back({ m_listener, POLLIN, 0 });
+            for (const Connection& connection : m_connections)
+                fds.push_back({ connection.fd, static_cast<short>(POLLIN | (connection.output.empty() ? 0 : POLLOUT)), 0 });
+
+            // The timeout only bounds how late stop() is noticed.
+            if (::poll(fds.data(), fds.size(), 100) <= 0)
+                continue;
+            Clock::time_point begin = Clock::now();
+
+            // New connections are added after the loop below: it walks the
+            // connections polled, by index.
+            for (size_t i = fds.size() - 1; i > 0; --i) {
+                Connection& connection = m_connections[i - 1];
+                bool open = true;
+                if (fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+                    open = this->receive(connection);
+                if (open && !connection.output.empty())
+                    open = this->send(connection);
+                if (!open)
+                    this->drop(i - 1);
+            }
+            if (fds[0].revents & POLLIN)
+                this->accept();
+
+            m_busy += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count();
+        }
+    }
+
+    void stop() { m_stopping.store(true, std::memory_order_relaxed); }
+
+    void close() {
+        for (size_t i = m_connections.size(); i > 0; --i)
+            this->drop(i - 1);
+        if (m_listener >= 0) {
+            ::close(m_listener);
+            ::unlink(m_path.c_str());
+            m_listener = -1;
+        }
+    }
+
+    // Time spent handling events, moves played and the most games hosted
+    // at once. Read them after run() returns.
+    double busySeconds() const { return m_busy / 1e9; }
+    uint64_t moves() const { return m_moves; }
+    size_t peakGames() const { return m_peak; }
+
+private:
+    struct Game {
+        PicariaBoard board;
+        int owner;          // file descriptor, or -1 for a free slot
+        uint16_t ply;
+        bool over;
+    };
+
+    struct Connection {
+        int fd;
+        std::vector<uint8_t> input;
+        std::vector<uint8_t> output;
+    };
+
+    int m_listener;
+    std::string m_path;
+    std::atomic<bool> m_stopping;
+    int64_t m_busy;
+    uint64_t m_moves;
+    size_t m_peak;
+    size_t m_hosted;
+    std::vector<Connection> m_connections;
+    std::vector<Game> m_games;
+    std::vector<uint32_t> m_free;
+
+    void accept() {
+        for (;;) {
+            int fd = ::accept(m_listener, nullptr, nullptr);
+            if (fd < 0)
+                return;
+            ::fcntl(fd, F_SETFL, O_NONBLOCK);
+            m_connections.push_back({ fd, {}, {} });
+        }
+    }
+
+    void drop(size_t index) {
+        int fd = m_connections[index].fd;
+        for (uint32_t id = 0; id < m_games.size(); ++id)
+            if (m_games[id].owner == fd)
+                this->free(id);
+        ::close(fd);
+        m_connections[index] = std::move(m_connections.back());
+        m_connections.pop_back();
+    }
+
+    void free(uint32_t id) {
+        m_games[id].owner = -1;
+        m_free.push_back(id);
+        --m_hosted;
+    }
+
+    bool receive(Connection& connection) {
+        uint8_t buffer[16384];
+        for (;;) {
+            ssize_t size = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+            if (size > 0) {
+                connection.input.insert(connection.input.end(), buffer, buffer + size);
+                continue;
+            }
+            if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+            if (size < 0 && errno == EINTR)
+                continue;
+            return false;
+        }
+
+        size_t count = connection.input.size() / sizeof(Request);
+        for (size_t i = 0; i < count; ++i) {
+            Request request;
+            std::memcpy(&request, connection.input.data() + i * sizeof(Request), sizeof(Request));
+            Update update = this->handle(connection.fd, request);
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&update);
+            connection.output.insert(connection.output.end(), bytes, bytes + sizeof(update));
+        }
+        connection.input.erase(connection.input.begin(), connection.input.begin() + count * sizeof(Request));
+        return true;
+    }
+
+    bool send(Connection& connection) {
+        size_t sent = 0;
+        while (sent < connection.output.size()) {
+            ssize_t size = ::send(connection.fd, connection.output.data() + sent, connection.output.size() - sent, MSG_NOSIGNAL);
+            if (size > 0)
+                sent += static_cast<size_t>(size);
+            else if (size < 0 && errno == EINTR)
+                continue;
+            else if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+            else
+                return false;
+        }
+        connection.output.erase(connection.output.begin(), connection.output.begin() + sent);
+        return true;
+    }
+
+    static uint8_t state(const Game& game) {
+        return static_cast<uint8_t>((game.board.player() == PicariaBoard::BluePlayer ? BlueToMove : 0) |
+                                    (game.board.phase() == PicariaBoard::MovePhase ? MovePhase : 0) |
+                                    (game.over ? GameOver : 0) |
+                                    (game.board.mode() == PicariaBoard::ThirteenHoles ? ThirteenHoles : 0));
+    }
+
+    Update handle(int fd, const Request& request) {
+        Update update = { request.game, Rejected, 0, 0, 0, 0 };
+
+        if (request.type == NewGame) {
+            if (request.mode > PicariaBoard::ThirteenHoles)
+                return update;
+            uint32_t id;
+            if (m_free.empty()) {
+                id = static_cast<uint32_t>(m_games.size());
+                m_games.push_back(Game());
+            }
+            else {
+                id = m_free.back();
+                m_free.pop_back();
+            }
+            Game& game = m_games[id];
+            game.board.reset(static_cast<PicariaBoard::Mode>(request.mode));
+            game.owner = fd;
+            game.ply = 0;
+            game.over = false;
+            m_peak = std::max(m_peak, ++m_hosted);
+
+            update.game = id;
+            update.type = Created;
+            update.state = Server::state(game);
+            return update;
+        }
+
+        if (request.game >= m_games.size() || m_games[request.game].owner != fd)
+            return update;
+        Game& game = m_games[request.game];
+
+        if (request.type == EndGame) {
+            this->free(request.game);
+            update.type = Ended;
+            return update;
+        }
+
+        // The same checks as a click on the board: only legal moves of the
+        // side to move, and nothing after the end of the game.
+        PicariaMove move = request.from < 0 ? PicariaMove::drop(request.to) : PicariaMove::slide(request.from, request.to);
+        bool valid = request.type == Move && request.to >= 0 && request.to < PicariaBoard::HoleCount &&
+                request.from < PicariaBoard::HoleCount;
+        if (!valid || game.over || !game.board.canPlay(move)) {
+            update.state = Server::state(game);
+            update.ply = game.ply;
+            return update;
+        }
+
+        PicariaBoard::Player mover = game.board.player();
+        uint16_t red = game.board.pieces(PicariaBoard::RedPlayer);
+        uint16_t blue = game.board.pieces(PicariaBoard::BluePlayer);
+        game.board.play(move);
+        ++game.ply;
+        ++m_moves;
+        game.over = game.board.hasLineThrough(mover, move.to) || !game.board.hasMoves();
+
+        update.type = Moved;
+        update.state = Server::state(game);
+        update.red = red ^ game.board.pieces(PicariaBoard::RedPlayer);
+        update.blue = blue ^ game.board.pieces(PicariaBoard::BluePlayer);
+        update.ply = game.ply;
+        return update;
+    }
+
+};
+
+// One connection of the load generator, playing random games on a
+// blocking socket. Every round sends one request per game and reads all
+// the updates back, so the server always has games games in flight.
+class Client {
+public:
+    Client(unsigned seed, int games) : m_fd(-1), m_random(seed), m_games(static_cast<size_t>(games)), m_errors(0), m_finished(0) {}
+    ~Client() { if (m_fd >= 0) ::close(m_fd); }
+
+    bool connect(const std::string& path) {
+        sockaddr_un address;
+        if (!bindAddress(path, address))
+            return false;
+        m_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        return m_fd >= 0 && ::connect(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    }
+
+    void run(Clock::time_point deadline) {
+        while (Clock::now() < deadline) {
+            // Finished games are ended and replaced by new ones.
+            m_requests.clear();
+            m_pending.clear();
+            for (size_t i = 0; i < m_games.size(); ++i) {
+                Game& game = m_games[i];
+                if (game.state == Over && game.id >= 0)
+                    this->request({ static_cast<uint32_t>(game.id), EndGame, 0, 0, 0 }, i);
+                if (game.state == Over) {
+                    uint8_t mode = m_random() & 1 ? PicariaBoard::ThirteenHoles : PicariaBoard::NineHoles;
+                    this->request({ 0, NewGame, mode, 0, 0 }, i);
+                    continue;
+                }
+
+                PicariaMoveList list = game.board.moves();
+                PicariaMove move = list[static_cast<int>(m_random() % static_cast<unsigned>(list.count))];
+                this->request({ static_cast<uint32_t>(game.id), Move, 0, move.from, move.to }, i);
+            }
+
+            Clock::time_point sent = Clock::now();
+            if (!this->write(m_requests.data(), m_requests.size() * sizeof(Request)))
+                return;
+
+            for (size_t i = 0; i < m_pending.size(); ++i) {
+                Update update;
+                if (!this->read(&update, sizeof(update)))
+                    return;
+                this->apply(m_games[m_pending[i]], m_requests[i], update, sent);
+            }
+        }
+    }
+
+    const std::vector<uint32_t>& latencies() const { return m_latencies; }
+    uint64_t errors() const { return m_errors; }
+    uint64_t finished() const { return m_finished; }
+
+private:
+    enum GameState { Playing, Over };
+
+    struct Game {
+        int64_t id = -1;
+        PicariaBoard board;
+        GameState state = Over;
+    };
+
+    int m_fd;
+    std::mt19937 m_random;
+    std::vector<Game> m_games;
+    std::vector<Request> m_requests;
+    std::vector<size_t> m_pending;
+    std::vector<uint32_t> m_latencies;
+    uint64_t m_errors;
+    uint64_t m_finished;
+
+    void request(const Request& request, size_t game) {
+        m_requests.push_back(request);
+        m_pending.push_back(game);
+    }
+
+    // Keeps the client's board by applying the deltas only, and checks it
+    // against the moves it asked for.
+    void apply(Game& game, const Request& request, const Update& update, Clock::time_point sent) {
+        switch (update.type) {
+        case Created:
+            game.id = update.game;
+            game.board.reset(update.state & ThirteenHoles ? PicariaBoard::ThirteenHoles : PicariaBoard::NineHoles);
+            game.state = Playing;
+            break;
+        case Moved: {
+            m_latencies.push_back(static_cast<uint32_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - sent).count()));
+            PicariaBoard expected = game.board;
+            expected.play(request.from < 0 ? PicariaMove::drop(request.to) : PicariaMove::slide(request.from, request.to));
+            game.board = PicariaBoard(game.board.mode(),
+                                      game.board.pieces(PicariaBoard::RedPlayer) ^ update.red,
+                                      game.board.pieces(PicariaBoard::BluePlayer) ^ update.blue,
+                                      update.state & BlueToMove ? PicariaBoard::BluePlayer : PicariaBoard::RedPlayer);
+            if (!(game.board == expected))
+                ++m_errors;
+            if (update.state & GameOver) {
+                game.state = Over;
+                ++m_finished;
+            }
+            break;
+        }
+        case Ended:
+            game.id = -1;
+            break;
+        default:
+            ++m_errors;
+            game.state = Over;
+            break;
+        }
+    }
+
+    bool write(const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        while (size > 0) {
+            ssize_t sent = ::send(m_fd, bytes, size, MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR)
+                continue;
+            if (sent <= 0)
+                return false;
+            bytes += sent;
+            size -= static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+    bool read(void* data, size_t size) {
+        uint8_t* bytes = static_cast<uint8_t*>(data);
+        while (size > 0) {
+            ssize_t received = ::recv(m_fd, bytes, size, 0);
+            if (received < 0 && errno == EINTR)
+                continue;
+            if (received <= 0)
+                return false;
+            bytes += received;
+            size -= static_cast<size_t>(received);
+        }
+        return true;
+    }
+
+};
+
+int serve(const std::string& path) {
+    Server server;
+    if (!server.listen(path))
+        return 1;
+    std::printf("serving on %s\n", path.c_str());
+    server.run();
+    return 0;
+}
+
+int load(int connections, int games, int seconds, std::string path) {
+    // Without a socket, the server runs here, so its own time is known.
+    Server server;
+    std::thread hosting;
+    bool hosted = path.empty();
+    if (hosted) {
+        path = "/tmp/picaria-server-" + std::to_string(::getpid()) + ".sock";
+        if (!server.listen(path))
+            return 1;
+        hosting = std::thread([&server]() { server.run(); });
+    }
+
+    std::vector<Client*> clients;
+    for (int i = 0; i < connections; ++i) {
+        clients.push_back(new Client(static_cast<unsigned>(i + 1), games));
+        if (!clients.back()->connect(path)) {
+            std::perror(path.c_str());
+            return 1;
+        }
+    }
+
+    Clock::time_point begin = Clock::now();
+    Clock::time_point deadline = begin + std::chrono::seconds(seconds);
+    std::vector<std::thread> threads;
+    for (Client* client : clients)
+        threads.emplace_back([client, deadline]() { client->run(deadline); });
+    for (std::thread& thread : threads)
+        thread.join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    std::vector<uint32_t> latencies;
+    uint64_t errors = 0;
+    uint64_t finished = 0;
+    for (Client* client : clients) {
+        latencies.insert(latencies.end(), client->latencies().begin(), client->latencies().end());
+        errors += client->errors();
+        finished += client->finished();
+        delete client;
+    }
+    if (latencies.empty()) {
+        std::printf("no moves played\n");
+        return 1;
+    }
+
+    auto percentile = [&latencies](double p) {
+        size_t index = std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()));
+        std::nth_element(latencies.begin(), latencies.begin() + static_cast<std::ptrdiff_t>(index), latencies.end());
+        return latencies[index] / 1000.0;
+    };
+
+    std::printf("%d connections, %d games each, %.1f s\n", connections, games, elapsed);
+    std::printf("moves:    %12.0f per second, %llu games finished, %llu errors\n",
+                latencies.size() / elapsed, static_cast<unsigned long long>(finished),
+                static_cast<unsigned long long>(errors));
+    std::printf("latency:  p50 %8.1f us, p99 %8.1f us\n", percentile(0.50), percentile(0.99));
+
+    if (hosted) {
+        server.stop();
+        hosting.join();
+        double busy = server.busySeconds();
+        std::printf("server:   %.2f s busy, %12.0f moves per core-second, %zu games hosted at most\n",
+                    busy, busy > 0 ? server.moves() / busy : 0.0, server.peakGames());
+    }
+
+    return errors == 0 ? 0 : 1;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    std::string command = argc > 1 ? argv[1] : "";
+
+    if (command == "serve")
+        return serve(argc > 2 ? argv[2] : "picaria.sock");
+
+    if (command == "load") {
+        int connections = argc > 2 ? std::atoi(argv[2]) : 4;
+        int games = argc > 3 ? std::atoi(argv[3]) : 1000;
+        int seconds = argc > 4 ? std::atoi(argv[4]) : 5;
+        return load(std::max(connections, 1), std::max(games, 1), std::max(seconds, 1), argc > 5 ? argv[5] : "");
+    }
+
+    std::fprintf(stderr, "usage: picaria-server serve [socket]\n"
+                         "       picaria-server load [connections] [games] [seconds] [socket]\n");
+    return 2;
+}
@@ -0,0 +1,48 @@
+#include "PicariaBook.h"
+#include "PicariaDataFile.h"
+#include "PicariaSolver.h"
+#include "PicariaTablebase.h"
+
+#include <chrono>
+#include <cstdio>
+
+// Solves both board modes by retrograde analysis and writes the tablebase
+// to the data file, keeping the opening book the file already has.
+//
+// usage: picaria-solve [output]    (default: picaria.db)
+int main(int argc, char *argv[]) {
+    const char* path = argc > 1 ? argv[1] : "picaria.db";
+    const char* names[2] = { "9 holes", "13 holes" };
+    const char* results[4] = { "unknown", "win", "loss", "draw" };
+
+    PicariaTablebase tablebase;
+    for (int mode = 0; mode < 2; ++mode) {
+        auto begin = std::chrono::steady_clock::now();
+        PicariaSolver solver(static_cast<PicariaBoard::Mode>(mode));
+        solver.solve();
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        std::printf("%s: %zu positions, %zu wins, %zu losses, %zu draws, %d rounds, %.3f s\n",
+                    names[mode], solver.entries().size(),
+                    solver.count(PicariaTablebase::WinResult),
+                    solver.count(PicariaTablebase::LossResult),
+                    solver.count(PicariaTablebase::DrawResult),
+                    solver.rounds(), elapsed);
+
+        tablebase.setEntries(solver.mode(), solver.takeEntries());
+
+        PicariaBoard board(static_cast<PicariaBoard::Mode>(mode));
+        std::printf("%s: start position is a %s in %d plies\n", names[mode],
+                    results[tablebase.result(board)], tablebase.distance(board));
+    }
+
+    PicariaBook book;
+    book.load(path);
+    if (!PicariaDataFile::save(path, &tablebase, &book)) {
+        std::fprintf(stderr, "could not write %s\n", path);
+        return 1;
+    }
+    std::printf("wrote %s\n", path);
+
+    return 0;
+}
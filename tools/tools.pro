@@ -0,0 +1,17 @@
+# Command line tools built on the Qt-free game core, and benchmarks of
+# the user interface.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    batch \
+    book \
+    holes \
+    journal \
+    mcts \
+    perft \
+    replay \
+    search \
+    server \
+    solve \
+    tournament
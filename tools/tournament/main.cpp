@@ -0,0 +1,341 @@
+#include "PicariaGame.h"
+#include "PicariaMcts.h"
+#include "PicariaPool.h"
+#include "PicariaSearch.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Plays matches between engine configurations on both boards, on every
+// core, and writes the result of every game and an Elo estimate of every
+// configuration. Each pairing plays the same random openings on each
+// board, once with each colour.
+//
+// Every engine is limited by depth or playouts, never by time, and every
+// game is seeded from the tournament seed and its number: the results
+// only depend on the seed, however the games are spread over threads.
+//
+// Engines: random, search:<depth> and mcts:<playouts>.
+//
+// usage: picaria-tournament [-g games] [-s seed] [-t threads] [-p maxPlies]
+//                           [-o openingPlies] [-r results.csv] [--gauntlet]
+//                           engine engine...
+//        (default: 100 games per pairing and board, seed 1, every core,
+//        200 plies, 2 opening plies, random search:2 search:4 mcts:1000)
+//
+// A round robin pairs every engine with every other; a gauntlet pairs the
+// first engine with each of the others.
+
+namespace {
+
+// Long enough never to cut a depth or playout limited think() short.
+const int unlimitedTime = 3600 * 1000;
+
+struct Player {
+    enum Kind { Random, Search, Mcts };
+
+    std::string name;
+    Kind kind;
+    int limit;
+};
+
+struct Result {
+    uint8_t mode;
+    uint8_t red;
+    uint8_t blue;
+    int8_t winner;      // PicariaBoard::Player, or -1 for a draw
+    uint16_t plies;
+};
+
+// The engines of one thread, by player.
+struct Engines {
+    std::vector<std::unique_ptr<PicariaSearch>> search;
+    std::vector<std::unique_ptr<PicariaMcts>> mcts;
+};
+
+uint64_t mix(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ull;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+uint64_t next(uint64_t& state) {
+    state = mix(state);
+    return state;
+}
+
+bool parsePlayer(const std::string& spec, Player& player) {
+    player.name = spec;
+    player.limit = 0;
+    if (spec == "random") {
+        player.kind = Player::Random;
+        return true;
+    }
+
+    size_t colon = spec.find(':');
+    std::string kind = spec.substr(0, colon);
+    if (colon == std::string::npos || (kind != "search" && kind != "mcts"))
+        return false;
+    player.kind = kind == "search" ? Player::Search : Player::Mcts;
+    player.limit = std::atoi(spec.c_str() + colon + 1);
+    return player.limit > 0 && player.limit <= (player.kind == Player::Search ? PicariaSearch::MaxDepth : 1 << 30);
+}
+
+class Tournament {
+public:
+    Tournament(std::vector<Player> players, bool gauntlet, int games, uint64_t seed, int maxPlies, int openingPlies)
+        : m_players(std::move(players)),
+          m_games(games + games % 2),
+          m_seed(seed),
+          m_maxPlies(maxPlies),
+          m_openingPlies(openingPlies) {
+        for (size_t a = 0; a < m_players.size(); ++a)
+            for (size_t b = a + 1; b < m_players.size() && (!gauntlet || a == 0); ++b)
+                m_pairings.push_back(std::make_pair(static_cast<int>(a), static_cast<int>(b)));
+    }
+
+    size_t count() const { return m_pairings.size() * 2 * m_games; }
+    const std::vector<Result>& results() const { return m_results; }
+
+    void run(PicariaPool& pool) {
+        m_results.assign(this->count(), Result());
+        m_engines.clear();
+        m_engines.resize(static_cast<size_t>(pool.threads()));
+        for (Engines& engines : m_engines) {
+            for (const Player& player : m_players) {
+                engines.search.emplace_back(player.kind == Player::Search ? new PicariaSearch(256 << 10, 1) : nullptr);
+                engines.mcts.emplace_back(player.kind == Player::Mcts ? new PicariaMcts(1, 1 << 14) : nullptr);
+                if (player.kind == Player::Mcts)
+                    engines.mcts.back()->setPlayoutLimit(static_cast<uint64_t>(player.limit));
+            }
+        }
+
+        pool.run(this->count(), [this](size_t index, int thread) {
+            m_results[index] = this->play(index, m_engines[static_cast<size_t>(thread)]);
+        });
+    }
+
+private:
+    std::vector<Player> m_players;
+    std::vector<std::pair<int, int>> m_pairings;
+    size_t m_games;
+    uint64_t m_seed;
+    int m_maxPlies;
+    int m_openingPlies;
+    std::vector<Result> m_results;
+    std::vector<Engines> m_engines;
+
+    // Games are numbered by pairing, then board, then game; games 2n and
+    // 2n + 1 of a pairing and board share an opening and swap colours.
+    Result play(size_t index, Engines& engines) {
+        const size_t game = index % m_games;
+        const PicariaBoard::Mode mode = static_cast<PicariaBoard::Mode>(index / m_games % 2);
+        const std::pair<int, int>& pairing = m_pairings[index / m_games / 2];
+
+        Result result;
+        result.mode = static_cast<uint8_t>(mode);
+        result.red = static_cast<uint8_t>(game % 2 ? pairing.second : pairing.first);
+        result.blue = static_cast<uint8_t>(game % 2 ? pairing.first : pairing.second);
+        result.winner = -1;
+
+        PicariaGame record(mode);
+        uint64_t opening = mix(m_seed ^ mix(game / 2 * 2 + static_cast<size_t>(mode)));
+        for (int ply = 0; ply < m_openingPlies && !record.isOver(); ++ply) {
+            PicariaMoveList list = record.board().moves();
+            record.play(list[static_cast<int>(next(opening) % static_cast<uint64_t>(list.count))]);
+        }
+
+        uint64_t random = mix(m_seed ^ mix(~index));
+        for (int id : { result.red, result.blue }) {
+            if (engines.search[id])
+                engines.search[id]->clear();
+            if (engines.mcts[id])
+                engines.mcts[id]->setSeed(next(random));
+        }
+
+        while (!record.isOver() && static_cast<int>(record.ply()) < m_maxPlies) {
+            const PicariaBoard& board = record.board();
+            const int id = board.player() == PicariaBoard::RedPlayer ? result.red : result.blue;
+            const Player& player = m_players[static_cast<size_t>(id)];
+
+            PicariaMove move;
+            if (player.kind == Player::Search)
+                move = engines.search[id]->think(board, unlimitedTime, player.limit);
+            else if (player.kind == Player::Mcts)
+                move = engines.mcts[id]->think(board, unlimitedTime);
+            else {
+                PicariaMoveList list = board.moves();
+                move = list[static_cast<int>(next(random) % static_cast<uint64_t>(list.count))];
+            }
+
+            // An engine that fails to move loses.
+            if (!record.play(move)) {
+                result.winner = static_cast<int8_t>(PicariaBoard::opponent(board.player()));
+                break;
+            }
+        }
+
+        if (record.isOver())
+            result.winner = static_cast<int8_t>(record.winner());
+        result.plies = static_cast<uint16_t>(record.ply());
+        return result;
+    }
+
+};
+
+// Bradley-Terry ratings by minorization-maximization, a draw counting as
+// half a win for each side. One extra draw between every pair that met
+// keeps the ratings finite when a player wins or loses every game. Elo
+// is relative to the first player.
+std::vector<double> elo(size_t count, const std::vector<Result>& results) {
+    std::vector<double> points(count * count, 0.0);
+    std::vector<double> games(count * count, 0.0);
+    for (const Result& result : results) {
+        double red = result.winner < 0 ? 0.5 : result.winner == PicariaBoard::RedPlayer ? 1.0 : 0.0;
+        points[result.red * count + result.blue] += red;
+        points[result.blue * count + result.red] += 1.0 - red;
+        games[result.red * count + result.blue] += 1.0;
+        games[result.blue * count + result.red] += 1.0;
+    }
+    for (size_t i = 0; i < count * count; ++i) {
+        if (games[i] > 0) {
+            points[i] += 0.5;
+            games[i] += 1.0;
+        }
+    }
+
+    std::vector<double> strength(count, 1.0);
+    for (int iteration = 0; iteration < 10000; ++iteration) {
+        double change = 0;
+        for (size_t i = 0; i < count; ++i) {
+            double won = 0;
+            double expected = 0;
+            for (size_t j = 0; j < count; ++j) {
+                won += points[i * count + j];
+                expected += games[i * count + j] / (strength[i] + strength[j]);
+            }
+            double updated = expected > 0 ? won / expected : strength[i];
+            change = std::max(change, std::fabs(updated - strength[i]) / strength[i]);
+            strength[i] = updated;
+        }
+        if (change < 1e-12)
+            break;
+    }
+
+    std::vector<double> ratings(count);
+    for (size_t i = 0; i < count; ++i)
+        ratings[i] = 400.0 * std::log10(strength[i] / strength[0]);
+    return ratings;
+}
+
+const char* format(const Result& result) {
+    return result.winner < 0 ? "1/2-1/2" : result.winner == PicariaBoard::RedPlayer ? "1-0" : "0-1";
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    int games = 100;
+    uint64_t seed = 1;
+    int threads = 0;
+    int maxPlies = 200;
+    int openingPlies = 2;
+    const char* output = nullptr;
+    bool gauntlet = false;
+    std::vector<Player> players;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        bool value = i + 1 < argc;
+        if (argument == "-g" && value)
+            games = std::atoi(argv[++i]);
+        else if (argument == "-s" && value)
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (argument == "-t" && value)
+            threads = std::atoi(argv[++i]);
+        else if (argument == "-p" && value)
+            maxPlies = std::atoi(argv[++i]);
+        else if (argument == "-o" && value)
+            openingPlies = std::atoi(argv[++i]);
+        else if (argument == "-r" && value)
+            output = argv[++i];
+        else if (argument == "--gauntlet")
+            gauntlet = true;
+        else {
+            Player player;
+            if (!parsePlayer(argument, player)) {
+                std::fprintf(stderr, "unknown engine %s: use random, search:<depth> or mcts:<playouts>\n", argv[i]);
+                return 2;
+            }
+            players.push_back(player);
+        }
+    }
+
+    if (players.empty())
+        for (const char* spec : { "random", "search:2", "search:4", "mcts:1000" }) {
+            players.push_back(Player());
+            parsePlayer(spec, players.back());
+        }
+    if (players.size() < 2 || players.size() > 255 || games <= 0 || maxPlies <= 0 || openingPlies < 0) {
+        std::fprintf(stderr, "need 2 to 255 engines, and positive games and plies\n");
+        return 2;
+    }
+
+    PicariaPool pool(threads);
+    Tournament tournament(players, gauntlet, games, seed, maxPlies, openingPlies);
+
+    auto begin = std::chrono::steady_clock::now();
+    tournament.run(pool);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    const std::vector<Result>& results = tournament.results();
+    std::printf("%zu games on %d threads, %.2f s, %.0f games/s, seed %llu\n", results.size(), pool.threads(),
+                elapsed, elapsed > 0 ? results.size() / elapsed : 0.0, static_cast<unsigned long long>(seed));
+
+    if (output) {
+        FILE* file = std::fopen(output, "w");
+        if (!file) {
+            std::perror(output);
+            return 1;
+        }
+        std::fprintf(file, "game,mode,red,blue,result,plies\n");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& result = results[i];
+            std::fprintf(file, "%zu,%d,%s,%s,%s,%d\n", i + 1, result.mode == PicariaBoard::NineHoles ? 9 : 13,
+                         players[result.red].name.c_str(), players[result.blue].name.c_str(), format(result), result.plies);
+        }
+        std::fclose(file);
+    }
+
+    std::vector<double> ratings = elo(players.size(), results);
+    std::printf("%-16s %8s %8s %8s %8s %8s %8s\n", "engine", "games", "wins", "draws", "losses", "score", "elo");
+    for (size_t id = 0; id < players.size(); ++id) {
+        int wins = 0;
+        int draws = 0;
+        int losses = 0;
+        for (const Result& result : results) {
+            if (result.red != id && result.blue != id)
+                continue;
+            if (result.winner < 0)
+                ++draws;
+            else if ((result.winner == PicariaBoard::RedPlayer) == (result.red == id))
+                ++wins;
+            else
+                ++losses;
+        }
+        int played = wins + draws + losses;
+        std::printf("%-16s %8d %8d %8d %8d %7.1f%% %8.0f\n", players[id].name.c_str(), played, wins, draws, losses,
+                    played > 0 ? 100.0 * (wins + 0.5 * draws) / played : 0.0, ratings[id]);
+    }
+
+    return 0;
+}